@@ -0,0 +1,301 @@
+#include "BatchMatcher.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace {
+
+const double COST_UNITS_PER_MILE = 1000.0; // Auction works on integer costs
+
+double milesBetween(const GeoPoint& a, const GeoPoint& b) {
+    double dx = a.x - b.x;
+    double dy = a.y - b.y;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+// Uniform grid over the drivers, stored as one sorted array plus per-cell offsets
+class DriverGrid {
+private:
+    const std::vector<MatchDriver>& drivers;
+    double cellSize;
+    double minX;
+    double minY;
+    int columns;
+    int rows;
+    std::vector<std::uint32_t> cellBegin;
+    std::vector<std::uint32_t> order; // Driver indices grouped by cell
+
+    int clampColumn(double x) const {
+        return std::max(0, std::min(columns - 1, static_cast<int>((x - minX) / cellSize)));
+    }
+    int clampRow(double y) const {
+        return std::max(0, std::min(rows - 1, static_cast<int>((y - minY) / cellSize)));
+    }
+
+public:
+    DriverGrid(const std::vector<MatchDriver>& driverList, double requestedCellSize)
+        : drivers(driverList), cellSize(requestedCellSize > 0.0 ? requestedCellSize : 0.5),
+          minX(0.0), minY(0.0), columns(1), rows(1) {
+        if (drivers.empty()) {
+            cellBegin.assign(2, 0);
+            return;
+        }
+
+        double maxX = drivers[0].position.x, maxY = drivers[0].position.y;
+        minX = maxX;
+        minY = maxY;
+        for (size_t i = 1; i < drivers.size(); ++i) {
+            minX = std::min(minX, drivers[i].position.x);
+            minY = std::min(minY, drivers[i].position.y);
+            maxX = std::max(maxX, drivers[i].position.x);
+            maxY = std::max(maxY, drivers[i].position.y);
+        }
+        // Grow cells when drivers are spread thin, so the grid stays O(drivers)
+        double cells = ((maxX - minX) / cellSize + 1.0) * ((maxY - minY) / cellSize + 1.0);
+        double limit = 4.0 * drivers.size() + 16.0;
+        if (cells > limit) {
+            cellSize *= std::sqrt(cells / limit);
+        }
+        columns = static_cast<int>((maxX - minX) / cellSize) + 1;
+        rows = static_cast<int>((maxY - minY) / cellSize) + 1;
+
+        // Counting sort of drivers by cell
+        std::vector<std::uint32_t> cellOf(drivers.size());
+        cellBegin.assign(static_cast<size_t>(columns) * rows + 1, 0);
+        for (size_t i = 0; i < drivers.size(); ++i) {
+            cellOf[i] = static_cast<std::uint32_t>(clampRow(drivers[i].position.y) * columns
+                                                   + clampColumn(drivers[i].position.x));
+            ++cellBegin[cellOf[i] + 1];
+        }
+        for (size_t c = 1; c < cellBegin.size(); ++c) {
+            cellBegin[c] += cellBegin[c - 1];
+        }
+        order.resize(drivers.size());
+        std::vector<std::uint32_t> next(cellBegin.begin(), cellBegin.end() - 1);
+        for (size_t i = 0; i < drivers.size(); ++i) {
+            order[next[cellOf[i]]++] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    // The k nearest drivers within radius, nearest first, as (miles, driver index)
+    void nearest(const GeoPoint& point, double radius, int k, std::vector<std::pair<double, std::uint32_t> >& out) const {
+        out.clear();
+        if (drivers.empty() || k <= 0) {
+            return;
+        }
+
+        int centerColumn = static_cast<int>(std::floor((point.x - minX) / cellSize));
+        int centerRow = static_cast<int>(std::floor((point.y - minY) / cellSize));
+        int maxRing = static_cast<int>(std::ceil(radius / cellSize)) + 1;
+
+        // Scan square rings of cells outwards; stop once a ring cannot hold anything closer
+        for (int ring = 0; ring <= maxRing; ++ring) {
+            if (static_cast<int>(out.size()) >= k && (ring - 1) * cellSize > out.back().first) {
+                break;
+            }
+            for (int row = centerRow - ring; row <= centerRow + ring; ++row) {
+                if (row < 0 || row >= rows) {
+                    continue;
+                }
+                bool edgeRow = row == centerRow - ring || row == centerRow + ring;
+                int step = edgeRow ? 1 : std::max(1, 2 * ring);
+                for (int column = centerColumn - ring; column <= centerColumn + ring; column += step) {
+                    if (column < 0 || column >= columns) {
+                        continue;
+                    }
+                    std::size_t cell = static_cast<std::size_t>(row) * columns + column;
+                    for (std::uint32_t i = cellBegin[cell]; i < cellBegin[cell + 1]; ++i) {
+                        double miles = milesBetween(point, drivers[order[i]].position);
+                        if (miles <= radius) {
+                            out.push_back(std::make_pair(miles, order[i]));
+                        }
+                    }
+                }
+            }
+            std::sort(out.begin(), out.end());
+            if (static_cast<int>(out.size()) > k) {
+                out.resize(k);
+            }
+        }
+    }
+};
+
+} // namespace
+
+BatchMatcher::BatchMatcher(const MatchConfig& matchConfig) : config(matchConfig), windowStart(0.0) {
+}
+
+void BatchMatcher::addRequest(const MatchRequest& request, double now) {
+    if (pending.empty()) {
+        windowStart = now;
+    }
+    pending.push_back(request);
+}
+
+bool BatchMatcher::isDue(double now) const {
+    return !pending.empty() && now - windowStart >= config.windowSeconds;
+}
+
+MatchResult BatchMatcher::matchPending(const std::vector<MatchDriver>& idleDrivers) {
+    MatchResult result = solve(pending, idleDrivers);
+    pending.clear();
+    return result;
+}
+
+MatchResult BatchMatcher::solve(const std::vector<MatchRequest>& requests, const std::vector<MatchDriver>& drivers) const {
+    MatchResult result;
+    result.totalPickupMiles = 0.0;
+    result.candidatePairs = 0;
+    result.bids = 0;
+
+    // Sparse benefit matrix (negated integer pickup cost), one row per request
+    const std::size_t requestCount = requests.size();
+    DriverGrid grid(drivers, config.cellSize);
+    std::vector<std::uint32_t> rowBegin(1, 0);
+    std::vector<std::uint32_t> arcDriver;
+    std::vector<std::int64_t> arcBenefit;
+    std::vector<double> arcMiles;
+    std::vector<std::pair<double, std::uint32_t> > nearest;
+    std::int64_t maxArcCost = 0;
+    for (std::size_t r = 0; r < requestCount; ++r) {
+        grid.nearest(requests[r].pickup, config.searchRadius, config.maxCandidates, nearest);
+        for (size_t c = 0; c < nearest.size(); ++c) {
+            std::int64_t cost = static_cast<std::int64_t>(std::llround(nearest[c].first * COST_UNITS_PER_MILE));
+            maxArcCost = std::max(maxArcCost, cost);
+            arcDriver.push_back(nearest[c].second);
+            arcBenefit.push_back(-cost);
+            arcMiles.push_back(nearest[c].first);
+        }
+        rowBegin.push_back(static_cast<std::uint32_t>(arcDriver.size()));
+    }
+    result.candidatePairs = arcDriver.size();
+
+    // Square auction over requests + drivers, so unmatched drivers cannot keep stale
+    // prices from earlier scaling phases:
+    //   request r      bids for its candidate drivers, or its own "unmatched" slot
+    //   idle slot of d bids for driver d (stays idle), or the unmatched slot of any
+    //                  request that has d as a candidate (d served it)
+    // Leaving a request unmatched costs more than the pickups of any whole matching.
+    // An augmenting path can reshuffle every matched pair to serve one more request, so
+    // the penalty must exceed min(requests, drivers) pickups, not just one: then matches
+    // are maximized first and total pickup distance minimized second.
+    const std::size_t driverCount = drivers.size();
+    const std::size_t size = requestCount + driverCount;
+    const std::int64_t scale = static_cast<std::int64_t>(size) + 1; // Final epsilon of 1 is then exact
+    const std::int64_t matchable = static_cast<std::int64_t>(std::min(requestCount, driverCount));
+    const std::int64_t unmatchedBenefit = -((matchable + 1) * maxArcCost + 1) * scale;
+
+    std::vector<std::uint32_t> begin(size + 1, 0);
+    std::vector<std::uint32_t> object;
+    std::vector<std::int64_t> benefit;
+    object.reserve(2 * arcDriver.size() + size);
+    benefit.reserve(2 * arcDriver.size() + size);
+    for (std::size_t r = 0; r < requestCount; ++r) {
+        for (std::uint32_t a = rowBegin[r]; a < rowBegin[r + 1]; ++a) {
+            object.push_back(arcDriver[a]);
+            benefit.push_back(arcBenefit[a] * scale);
+        }
+        object.push_back(static_cast<std::uint32_t>(driverCount + r));
+        benefit.push_back(unmatchedBenefit);
+        begin[r + 1] = static_cast<std::uint32_t>(object.size());
+    }
+    std::vector<std::uint32_t> servedBegin(driverCount + 1, 0); // Driver -> requests listing it
+    for (size_t a = 0; a < arcDriver.size(); ++a) {
+        ++servedBegin[arcDriver[a] + 1];
+    }
+    for (std::size_t d = 0; d < driverCount; ++d) {
+        servedBegin[d + 1] += servedBegin[d];
+    }
+    std::vector<std::uint32_t> served(arcDriver.size());
+    std::vector<std::uint32_t> fill(servedBegin.begin(), servedBegin.end() - 1);
+    for (std::size_t r = 0; r < requestCount; ++r) {
+        for (std::uint32_t a = rowBegin[r]; a < rowBegin[r + 1]; ++a) {
+            served[fill[arcDriver[a]]++] = static_cast<std::uint32_t>(r);
+        }
+    }
+    for (std::size_t d = 0; d < driverCount; ++d) {
+        object.push_back(static_cast<std::uint32_t>(d));
+        benefit.push_back(0);
+        for (std::uint32_t k = servedBegin[d]; k < servedBegin[d + 1]; ++k) {
+            object.push_back(static_cast<std::uint32_t>(driverCount + served[k]));
+            benefit.push_back(0);
+        }
+        begin[requestCount + d + 1] = static_cast<std::uint32_t>(object.size());
+    }
+
+    const std::uint32_t NONE = std::numeric_limits<std::uint32_t>::max();
+    const std::int64_t range = -unmatchedBenefit; // Largest benefit spread
+    std::vector<std::int64_t> price(size, 0);
+    std::vector<std::uint32_t> owner(size, NONE);     // Object -> bidder
+    std::vector<std::uint32_t> assigned(size, NONE);  // Bidder -> object
+    std::vector<std::uint32_t> queue;
+
+    std::int64_t epsilon = std::max<std::int64_t>(1, range / 8);
+    for (;;) {
+        // Each scaling phase restarts the assignment but keeps the prices
+        std::fill(owner.begin(), owner.end(), NONE);
+        std::fill(assigned.begin(), assigned.end(), NONE);
+        queue.clear();
+        for (std::size_t b = size; b-- > 0;) {
+            queue.push_back(static_cast<std::uint32_t>(b));
+        }
+
+        while (!queue.empty()) {
+            std::uint32_t bidder = queue.back();
+            queue.pop_back();
+            ++result.bids;
+
+            std::int64_t bestValue = std::numeric_limits<std::int64_t>::min();
+            std::int64_t secondValue = std::numeric_limits<std::int64_t>::min();
+            std::uint32_t bestObject = NONE;
+            for (std::uint32_t a = begin[bidder]; a < begin[bidder + 1]; ++a) {
+                std::int64_t value = benefit[a] - price[object[a]];
+                if (value > bestValue) {
+                    secondValue = bestValue;
+                    bestValue = value;
+                    bestObject = object[a];
+                } else if (value > secondValue) {
+                    secondValue = value;
+                }
+            }
+            if (secondValue == std::numeric_limits<std::int64_t>::min()) {
+                secondValue = bestValue - range; // Only one option: any raise keeps it
+            }
+
+            price[bestObject] += bestValue - secondValue + epsilon;
+            if (owner[bestObject] != NONE) {
+                assigned[owner[bestObject]] = NONE;
+                queue.push_back(owner[bestObject]);
+            }
+            owner[bestObject] = bidder;
+            assigned[bidder] = bestObject;
+        }
+
+        if (epsilon == 1) {
+            break;
+        }
+        epsilon = std::max<std::int64_t>(1, epsilon / 5);
+    }
+
+    for (std::size_t r = 0; r < requestCount; ++r) {
+        if (assigned[r] >= driverCount) {
+            result.unmatchedRequests.push_back(requests[r].requestID);
+            continue;
+        }
+        MatchAssignment assignment;
+        assignment.requestID = requests[r].requestID;
+        assignment.driverID = drivers[assigned[r]].driverID;
+        assignment.pickupMiles = 0.0;
+        for (std::uint32_t a = rowBegin[r]; a < rowBegin[r + 1]; ++a) {
+            if (arcDriver[a] == assigned[r]) {
+                assignment.pickupMiles = arcMiles[a];
+                break;
+            }
+        }
+        result.totalPickupMiles += assignment.pickupMiles;
+        result.assignments.push_back(assignment);
+    }
+    return result;
+}
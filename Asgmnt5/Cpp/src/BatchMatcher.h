@@ -0,0 +1,81 @@
+#ifndef BATCHMATCHER_H
+#define BATCHMATCHER_H
+
+#include <cstddef>
+#include <vector>
+
+// Position on a local planar grid, in miles
+struct GeoPoint {
+    double x;
+    double y;
+};
+
+struct MatchRequest {
+    int requestID;
+    GeoPoint pickup;
+};
+
+struct MatchDriver {
+    int driverID;
+    GeoPoint position;
+};
+
+struct MatchAssignment {
+    int requestID;
+    int driverID;
+    double pickupMiles;
+};
+
+struct MatchConfig {
+    double windowSeconds;   // How long requests are collected before a batch is solved
+    double searchRadius;    // Drivers farther than this (miles) are never considered
+    int maxCandidates;      // Nearest drivers kept per request
+    double cellSize;        // Spatial grid cell, in miles
+
+    MatchConfig() : windowSeconds(2.0), searchRadius(3.0), maxCandidates(12), cellSize(0.5) {}
+};
+
+struct MatchResult {
+    std::vector<MatchAssignment> assignments;
+    std::vector<int> unmatchedRequests;
+    double totalPickupMiles;
+    std::size_t candidatePairs;  // Edges of the sparse cost matrix
+    std::size_t bids;            // Auction iterations, for tuning
+};
+
+// Batched ride matching. Requests are collected for a short window and then assigned
+// together, minimizing total pickup distance instead of greedily taking the nearest
+// driver for each request in turn.
+//
+// Each request only considers its maxCandidates nearest drivers within searchRadius,
+// found through a uniform grid over the idle drivers, so the cost matrix stays sparse.
+// The assignment is solved with Bertsekas' auction algorithm with epsilon scaling:
+// requests bid for drivers, prices rise until every request holds its best offer.
+// A request may stay unmatched when its candidates are taken, so the problem is always
+// feasible; the penalty for it exceeds the pickups of any whole matching, so the number of
+// matches is maximized first and total pickup distance only second.
+class BatchMatcher {
+private:
+    MatchConfig config;
+    std::vector<MatchRequest> pending;
+    double windowStart;
+
+public:
+    // Constructor
+    explicit BatchMatcher(const MatchConfig& matchConfig = MatchConfig());
+
+    // Collect a request; the first request of a batch opens the window
+    void addRequest(const MatchRequest& request, double now);
+
+    // True once the current batch's window has elapsed
+    bool isDue(double now) const;
+    std::size_t getPendingCount() const { return pending.size(); }
+
+    // Solve the pending batch against the idle drivers and start a new batch
+    MatchResult matchPending(const std::vector<MatchDriver>& idleDrivers);
+
+    // Solve one batch; each driver is assigned to at most one request
+    MatchResult solve(const std::vector<MatchRequest>& requests, const std::vector<MatchDriver>& drivers) const;
+};
+
+#endif // BATCHMATCHER_H
@@ -0,0 +1,99 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// Lock-free bounded multi-producer/multi-consumer queue (Vyukov's ring buffer).
+// Each cell carries a sequence number that tells producers and consumers whether
+// it is free or filled, so pushes and pops only contend on one atomic each.
+// Capacity is rounded up to a power of two.
+template <typename T>
+class BoundedQueue {
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    static const std::size_t CACHE_LINE = 64;
+
+    std::unique_ptr<Cell[]> cells;
+    std::size_t mask;
+    char padding0[CACHE_LINE];
+    std::atomic<std::size_t> enqueuePos;
+    char padding1[CACHE_LINE];
+    std::atomic<std::size_t> dequeuePos;
+    char padding2[CACHE_LINE];
+
+    BoundedQueue(const BoundedQueue&);            // Non-copyable
+    BoundedQueue& operator=(const BoundedQueue&);
+
+public:
+    // Constructor
+    explicit BoundedQueue(std::size_t capacity) : enqueuePos(0), dequeuePos(0) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Returns false when the queue is full
+    bool tryPush(const T& value) {
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns false when the queue is empty
+    bool tryPop(T& value) {
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells[pos & mask];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = cell.data;
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Snapshot of the number of queued items; may be stale under concurrency
+    std::size_t sizeApprox() const {
+        std::size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        std::size_t head = dequeuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    std::size_t capacity() const { return mask + 1; }
+};
+
+#endif // BOUNDEDQUEUE_H
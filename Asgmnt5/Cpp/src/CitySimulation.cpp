@@ -0,0 +1,322 @@
+#include "CitySimulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <sstream>
+#include "StandardRide.h"
+#include "PremiumRide.h"
+
+void SimulationReport::print() const {
+    std::cout << "\n=== Simulation Report ===" << std::endl;
+    std::cout << "Events processed: " << eventsProcessed << std::endl;
+    std::cout << "Rides requested: " << ridesRequested << std::endl;
+    std::cout << "Rides completed: " << ridesCompleted << std::endl;
+    std::cout << "Rides abandoned: " << ridesAbandoned << std::endl;
+    std::cout << "Mean wait: " << meanWaitMinutes << " minutes" << std::endl;
+    std::cout << "P90 wait: " << p90WaitMinutes << " minutes" << std::endl;
+    std::cout << "Driver utilization: " << (driverUtilization * 100.0) << "%" << std::endl;
+    std::cout << "Throughput: " << ridesPerHour << " rides per hour" << std::endl;
+    std::cout << "Total fares: $" << totalFares << std::endl;
+    for (size_t i = 0; i < topEarners.size(); ++i) {
+        std::cout << "Top earner #" << (i + 1) << ": Driver " << topEarners[i].driverID
+                  << " ($" << topEarners[i].score << ")" << std::endl;
+    }
+    std::cout << "Wall time: " << wallSeconds << " s (" << eventsPerSecond << " events/s)" << std::endl;
+    std::cout << "=========================" << std::endl;
+}
+
+bool SimulationConfig::isValid() const {
+    const char* problem = nullptr;
+    if (!(durationHours > 0.0)) {
+        problem = "durationHours must be positive";
+    } else if (driverCount < 0) {
+        problem = "driverCount must not be negative";
+    } else if (riderCount <= 0) {
+        problem = "riderCount must be positive";
+    } else if (locationCount <= 0) {
+        problem = "locationCount must be positive";
+    } else if (!(requestsPerHour >= 0.0)) {
+        problem = "requestsPerHour must not be negative";
+    } else if (!(premiumShare >= 0.0 && premiumShare <= 1.0)) {
+        problem = "premiumShare must be between 0 and 1";
+    } else if (!(meanTripMiles > 0.0) || !(averageSpeedMph > 0.0)) {
+        problem = "meanTripMiles and averageSpeedMph must be positive";
+    } else if (!(meanPickupMinutes >= 0.0) || !(riderPatienceMinutes >= 0.0) || !(meanBreakHours >= 0.0)) {
+        problem = "pickup, patience and break times must not be negative";
+    } else if (!(shiftHours > 0.0)) {
+        problem = "shiftHours must be positive";
+    }
+
+    if (problem != nullptr) {
+        std::cout << "Invalid simulation config: " << problem << std::endl;
+        return false;
+    }
+    return true;
+}
+
+CitySimulation::CitySimulation(const SimulationConfig& simulationConfig)
+    : config(simulationConfig), configValid(simulationConfig.isValid()), rngState(simulationConfig.seed),
+      nextSequence(0), nextRideID(1), now(0.0), busyHours(0.0), shiftHoursWorked(0.0) {
+    report = SimulationReport();
+    if (!configValid) {
+        return;
+    }
+
+    drivers.reserve(config.driverCount);
+    driverStates.resize(config.driverCount);
+    for (int i = 0; i < config.driverCount; ++i) {
+        std::ostringstream name;
+        name << "Driver " << (i + 1);
+        drivers.push_back(Driver(i + 1, name.str()));
+        DriverState& state = driverStates[i];
+        state.onShift = false;
+        state.idle = false;
+        state.busy = false;
+        state.shiftEndPending = false;
+        state.busySince = 0.0;
+        state.shiftSince = 0.0;
+    }
+    for (int i = 0; i < config.driverCount; ++i) {
+        leaderboard.track(drivers[i]); // After the vector is filled, so the drivers no longer move
+    }
+
+    riders.reserve(config.riderCount);
+    for (int i = 0; i < config.riderCount; ++i) {
+        std::ostringstream name;
+        name << "Rider " << (i + 1);
+        riders.push_back(Rider(i + 1, name.str()));
+    }
+
+    locations.reserve(config.locationCount);
+    for (int i = 0; i < config.locationCount; ++i) {
+        std::ostringstream name;
+        name << "Location " << (i + 1);
+        locations.push_back(LocationTable::global().intern(name.str()));
+    }
+}
+
+std::uint64_t CitySimulation::nextRandom() {
+    // splitmix64
+    std::uint64_t z = (rngState += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+double CitySimulation::uniform() {
+    return (nextRandom() >> 11) * (1.0 / 9007199254740992.0); // [0, 1)
+}
+
+double CitySimulation::exponential(double mean) {
+    return -mean * std::log(1.0 - uniform());
+}
+
+void CitySimulation::schedule(double time, EventType type, int subject) {
+    Event event;
+    event.time = time;
+    event.sequence = nextSequence++;
+    event.type = type;
+    event.subject = subject;
+    events.push_back(event);
+    std::push_heap(events.begin(), events.end(), std::greater<Event>());
+}
+
+SimulationReport CitySimulation::run() {
+    if (!configValid) {
+        return report;
+    }
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Stagger the first shifts so the fleet does not clock in all at once
+    double staggerHours = std::min(config.shiftHours + config.meanBreakHours, config.durationHours);
+    for (int i = 0; i < config.driverCount; ++i) {
+        schedule(uniform() * staggerHours, EventType::ShiftStart, i);
+    }
+    if (config.requestsPerHour > 0.0) {
+        schedule(exponential(1.0 / config.requestsPerHour), EventType::RideRequest, -1);
+    }
+
+    while (!events.empty()) {
+        std::pop_heap(events.begin(), events.end(), std::greater<Event>());
+        Event event = events.back();
+        events.pop_back();
+        if (event.time > config.durationHours) {
+            break;
+        }
+
+        now = event.time;
+        ++report.eventsProcessed;
+
+        switch (event.type) {
+        case EventType::RideRequest:
+            handleRideRequest();
+            break;
+        case EventType::ShiftStart:
+            handleShiftStart(event.subject);
+            break;
+        case EventType::ShiftEnd:
+            handleShiftEnd(event.subject);
+            break;
+        case EventType::TripComplete:
+            handleTripComplete(event.subject);
+            break;
+        }
+    }
+
+    now = config.durationHours;
+    closeAccounting();
+
+    report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    report.eventsPerSecond = report.wallSeconds > 0.0 ? report.eventsProcessed / report.wallSeconds : 0.0;
+    return report;
+}
+
+void CitySimulation::handleRideRequest() {
+    schedule(now + exponential(1.0 / config.requestsPerHour), EventType::RideRequest, -1);
+
+    PendingRequest request;
+    request.time = now;
+    request.riderIndex = static_cast<int>(uniform() * config.riderCount);
+    request.type = uniform() < config.premiumShare ? RideType::Premium : RideType::Standard;
+    request.pickup = locations[static_cast<size_t>(uniform() * locations.size())];
+    request.dropoff = locations[static_cast<size_t>(uniform() * locations.size())];
+    request.distance = std::max(0.5, exponential(config.meanTripMiles));
+    ++report.ridesRequested;
+
+    // Riders at the front of the queue that ran out of patience leave
+    double patienceHours = config.riderPatienceMinutes / 60.0;
+    while (!waiting.empty() && now - waiting.front().time > patienceHours) {
+        waiting.pop_front();
+        ++report.ridesAbandoned;
+    }
+
+    int driver = takeIdleDriver();
+    if (driver >= 0) {
+        dispatch(driver, request);
+    } else {
+        waiting.push_back(request);
+    }
+}
+
+void CitySimulation::handleShiftStart(int driver) {
+    DriverState& state = driverStates[driver];
+    state.onShift = true;
+    state.shiftEndPending = false;
+    state.shiftSince = now;
+    schedule(now + config.shiftHours, EventType::ShiftEnd, driver);
+    makeIdle(driver);
+}
+
+void CitySimulation::handleShiftEnd(int driver) {
+    DriverState& state = driverStates[driver];
+    if (state.busy) {
+        // Finish the current trip first
+        state.shiftEndPending = true;
+        return;
+    }
+
+    state.onShift = false;
+    state.idle = false; // Stale idle-pool entries are skipped by takeIdleDriver()
+    shiftHoursWorked += now - state.shiftSince;
+    schedule(now + exponential(config.meanBreakHours), EventType::ShiftStart, driver);
+}
+
+void CitySimulation::handleTripComplete(int driver) {
+    DriverState& state = driverStates[driver];
+    state.busy = false;
+    busyHours += now - state.busySince;
+    ++report.ridesCompleted;
+
+    if (state.shiftEndPending) {
+        state.shiftEndPending = false;
+        handleShiftEnd(driver);
+    } else {
+        makeIdle(driver);
+    }
+}
+
+void CitySimulation::dispatch(int driver, const PendingRequest& request) {
+    double pickupHours = exponential(config.meanPickupMinutes) / 60.0;
+
+    Ride* ride;
+    if (request.type == RideType::Premium) {
+        ride = ridePool.create<PremiumRide>(nextRideID++, request.pickup, request.dropoff, request.distance);
+    } else {
+        ride = ridePool.create<StandardRide>(nextRideID++, request.pickup, request.dropoff, request.distance);
+    }
+    ride->setRequestTime(static_cast<std::time_t>(request.time * 3600.0));
+
+    std::shared_ptr<Ride> handle = RidePool::handle(ride);
+    riders[request.riderIndex].recordRequest(handle);
+    drivers[driver].recordRide(handle);
+    report.totalFares += ride->fare();
+
+    waitMinutes.push_back(static_cast<float>((now - request.time + pickupHours) * 60.0));
+
+    DriverState& state = driverStates[driver];
+    state.busy = true;
+    state.busySince = now;
+    schedule(now + pickupHours + request.distance / config.averageSpeedMph, EventType::TripComplete, driver);
+}
+
+void CitySimulation::makeIdle(int driver) {
+    double patienceHours = config.riderPatienceMinutes / 60.0;
+    while (!waiting.empty()) {
+        PendingRequest request = waiting.front();
+        waiting.pop_front();
+        if (now - request.time > patienceHours) {
+            ++report.ridesAbandoned;
+            continue;
+        }
+        dispatch(driver, request);
+        return;
+    }
+
+    driverStates[driver].idle = true;
+    idleDrivers.push_back(driver);
+}
+
+int CitySimulation::takeIdleDriver() {
+    while (!idleDrivers.empty()) {
+        int driver = idleDrivers.back();
+        idleDrivers.pop_back();
+        if (driverStates[driver].idle) {
+            driverStates[driver].idle = false;
+            return driver;
+        }
+    }
+    return -1;
+}
+
+void CitySimulation::closeAccounting() {
+    // Requests nobody picked up before the end were not served either
+    report.ridesAbandoned += waiting.size();
+    waiting.clear();
+
+    for (size_t i = 0; i < driverStates.size(); ++i) {
+        const DriverState& state = driverStates[i];
+        if (state.onShift) {
+            shiftHoursWorked += now - state.shiftSince;
+        }
+        if (state.busy) {
+            busyHours += now - state.busySince;
+        }
+    }
+
+    if (!waitMinutes.empty()) {
+        double sum = 0.0;
+        for (size_t i = 0; i < waitMinutes.size(); ++i) {
+            sum += waitMinutes[i];
+        }
+        report.meanWaitMinutes = sum / waitMinutes.size();
+
+        size_t p90 = waitMinutes.size() * 9 / 10;
+        std::nth_element(waitMinutes.begin(), waitMinutes.begin() + p90, waitMinutes.end());
+        report.p90WaitMinutes = waitMinutes[p90];
+    }
+
+    report.driverUtilization = shiftHoursWorked > 0.0 ? busyHours / shiftHoursWorked : 0.0;
+    report.ridesPerHour = config.durationHours > 0.0 ? report.ridesCompleted / config.durationHours : 0.0;
+    report.topEarners = leaderboard.topK(DriverLeaderboard::Metric::Earnings, 3);
+}
@@ -0,0 +1,149 @@
+#ifndef CITYSIMULATION_H
+#define CITYSIMULATION_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "Driver.h"
+#include "DriverLeaderboard.h"
+#include "Rider.h"
+#include "RidePool.h"
+#include "LocationTable.h"
+
+// Parameters of a simulated city. Times are in hours, distances in miles.
+struct SimulationConfig {
+    std::uint64_t seed;
+    double durationHours;
+    int driverCount;
+    int riderCount;
+    int locationCount;
+    double requestsPerHour;     // Poisson arrival rate of ride requests
+    double premiumShare;        // Fraction of requests that are premium rides
+    double meanTripMiles;       // Exponentially distributed trip length
+    double averageSpeedMph;
+    double meanPickupMinutes;   // Time for a driver to reach the rider
+    double riderPatienceMinutes;// Requests waiting longer than this are abandoned
+    double shiftHours;          // Length of one driver shift
+    double meanBreakHours;      // Exponentially distributed time between shifts
+
+    SimulationConfig()
+        : seed(42), durationHours(24.0), driverCount(1000), riderCount(20000), locationCount(500),
+          requestsPerHour(1500.0), premiumShare(0.2), meanTripMiles(5.0), averageSpeedMph(20.0),
+          meanPickupMinutes(4.0), riderPatienceMinutes(10.0), shiftHours(8.0), meanBreakHours(4.0) {
+    }
+
+    // Check every parameter; prints the first problem found
+    bool isValid() const;
+};
+
+// Results of a simulation run
+struct SimulationReport {
+    std::uint64_t eventsProcessed;
+    std::uint64_t ridesRequested;
+    std::uint64_t ridesCompleted;
+    std::uint64_t ridesAbandoned;   // Including requests still waiting when the run ends
+    double meanWaitMinutes;     // Request to pickup, completed rides only
+    double p90WaitMinutes;
+    double driverUtilization;   // Busy time / on-shift time
+    double ridesPerHour;        // Completed rides per simulated hour
+    double totalFares;
+    double wallSeconds;
+    double eventsPerSecond;
+    std::vector<LeaderboardEntry> topEarners;
+
+    void print() const;
+};
+
+// Discrete-event simulation of a city driving the Driver, Rider and Ride classes.
+// Events are kept in a binary min-heap ordered by time; ties are broken by insertion
+// order so a given seed always produces the same run.
+class CitySimulation {
+private:
+    enum class EventType {
+        RideRequest,
+        ShiftStart,
+        ShiftEnd,
+        TripComplete
+    };
+
+    struct Event {
+        double time;
+        std::uint64_t sequence;
+        EventType type;
+        int subject; // Driver index; unused for ride requests
+
+        bool operator>(const Event& other) const {
+            return time > other.time || (time == other.time && sequence > other.sequence);
+        }
+    };
+
+    struct DriverState {
+        bool onShift;
+        bool idle;          // On shift and in the idle pool
+        bool busy;
+        bool shiftEndPending; // Shift ended mid-trip; clock out on completion
+        double busySince;
+        double shiftSince;
+    };
+
+    struct PendingRequest {
+        double time;
+        int riderIndex;
+        RideType type;
+        LocationID pickup;
+        LocationID dropoff;
+        double distance;
+    };
+
+    SimulationConfig config;
+    bool configValid;
+    std::uint64_t rngState;
+    std::uint64_t nextSequence;
+    int nextRideID;
+    double now;
+
+    std::vector<Event> events;
+    std::vector<Driver> drivers;
+    std::vector<Rider> riders;
+    std::vector<DriverState> driverStates;
+    std::vector<int> idleDrivers;
+    std::deque<PendingRequest> waiting;
+    std::vector<LocationID> locations;
+    std::vector<float> waitMinutes;
+    RidePool ridePool;
+    DriverLeaderboard leaderboard; // Tracks every driver
+
+    double busyHours;
+    double shiftHoursWorked;
+    SimulationReport report;
+
+    // Deterministic random numbers, identical on every platform for a given seed
+    std::uint64_t nextRandom();
+    double uniform();
+    double exponential(double mean);
+
+    void schedule(double time, EventType type, int subject);
+    void handleRideRequest();
+    void handleShiftStart(int driver);
+    void handleShiftEnd(int driver);
+    void handleTripComplete(int driver);
+    void dispatch(int driver, const PendingRequest& request);
+    void makeIdle(int driver);
+    int takeIdleDriver();
+    void closeAccounting();
+
+public:
+    // Constructor
+    explicit CitySimulation(const SimulationConfig& simulationConfig);
+
+    // Run until durationHours of simulated time have elapsed; an invalid
+    // configuration runs nothing and returns an empty report
+    SimulationReport run();
+
+    // Access to the simulated population after a run
+    const std::vector<Driver>& getDrivers() const { return drivers; }
+    const std::vector<Rider>& getRiders() const { return riders; }
+    const DriverLeaderboard& getLeaderboard() const { return leaderboard; }
+};
+
+#endif // CITYSIMULATION_H
@@ -0,0 +1,276 @@
+#include "DispatchService.h"
+#include <chrono>
+#include "StandardRide.h"
+#include "PremiumRide.h"
+
+DispatchService::DispatchService(const DispatchConfig& dispatchConfig)
+    : config(dispatchConfig), running(false), submitted(0), rejected(0), messagesPosted(0), messagesApplied(0) {
+    if (config.shardCount < 1) {
+        config.shardCount = 1;
+    }
+    for (int i = 0; i < config.shardCount; ++i) {
+        shards.push_back(std::unique_ptr<Shard>(new Shard(i, config.shardCount, config.queueCapacity)));
+    }
+}
+
+DispatchService::~DispatchService() {
+    stop();
+}
+
+int DispatchService::shardForZone(int zone) const {
+    int shard = zone % config.shardCount;
+    return shard < 0 ? shard + config.shardCount : shard;
+}
+
+void DispatchService::addDriver(Driver& driver, int zone) {
+    if (running.load()) {
+        std::cout << "Cannot add driver while dispatch is running" << std::endl;
+        return;
+    }
+    if (driverSlots.find(driver.getDriverID()) != driverSlots.end()) {
+        std::cout << "Driver " << driver.getDriverID() << " is already registered" << std::endl;
+        return;
+    }
+    Shard& shard = *shards[shardForZone(zone)];
+    int slot = static_cast<int>(shard.drivers.size());
+    shard.drivers.push_back(&driver);
+    shard.driverBusy.push_back(0);
+    shard.idleDrivers.push_back(slot);
+    driverSlots[driver.getDriverID()] = std::make_pair(shard.index, slot);
+}
+
+void DispatchService::addRider(Rider& rider, int homeZone) {
+    if (running.load()) {
+        std::cout << "Cannot add rider while dispatch is running" << std::endl;
+        return;
+    }
+    riders[rider.getRiderID()] = std::make_pair(&rider, shardForZone(homeZone));
+}
+
+void DispatchService::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    for (size_t i = 0; i < shards.size(); ++i) {
+        workers.push_back(std::thread(&DispatchService::workerLoop, this, std::ref(*shards[i])));
+    }
+}
+
+void DispatchService::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+    workers.clear();
+
+    // Workers are gone, so apply any late cross-shard messages here
+    for (size_t i = 0; i < shards.size(); ++i) {
+        drainMailbox(*shards[i]);
+    }
+}
+
+bool DispatchService::submit(const DispatchRequest& request) {
+    if (riders.find(request.riderID) == riders.end()
+        || !shards[shardForZone(request.zone)]->requests.tryPush(request)) {
+        rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    submitted.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool DispatchService::releaseDriver(int driverID) {
+    std::unordered_map<int, std::pair<int, int>>::const_iterator it = driverSlots.find(driverID);
+    if (it == driverSlots.end() || !running.load()) {
+        return false;
+    }
+    Message message;
+    message.type = MessageType::DriverReleased;
+    message.driverSlot = it->second.second;
+    message.rider = nullptr;
+    message.ride = nullptr;
+    post(*shards[it->second.first], message);
+    return true;
+}
+
+void DispatchService::post(Shard& target, const Message& message) {
+    messagesPosted.fetch_add(1, std::memory_order_relaxed);
+    for (int attempt = 0; attempt < POST_RETRIES; ++attempt) {
+        if (target.mailbox.tryPush(message)) {
+            return;
+        }
+        std::this_thread::yield(); // Backpressure: the owner is behind on its mailbox
+    }
+
+    // Never wait for the owner indefinitely: two workers posting into each other's
+    // full mailboxes would otherwise deadlock
+    std::lock_guard<std::mutex> guard(target.overflowLock);
+    target.overflow.push_back(message);
+    target.hasOverflow.store(true, std::memory_order_release);
+}
+
+void DispatchService::workerLoop(Shard& shard) {
+    const int BATCH = 64;
+    unsigned emptySpins = 0;
+
+    while (running.load(std::memory_order_relaxed)) {
+        bool worked = drainMailbox(shard);
+        for (int i = 0; i < BATCH && serveOne(shard); ++i) {
+            worked = true;
+        }
+
+        if (worked) {
+            emptySpins = 0;
+        } else if (++emptySpins < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+}
+
+bool DispatchService::drainMailbox(Shard& shard) {
+    bool worked = false;
+    Message message;
+    while (shard.mailbox.tryPop(message)) {
+        applyMessage(shard, message);
+        worked = true;
+    }
+
+    if (shard.hasOverflow.load(std::memory_order_acquire)) {
+        std::vector<Message> spilled;
+        {
+            std::lock_guard<std::mutex> guard(shard.overflowLock);
+            spilled.swap(shard.overflow);
+            shard.hasOverflow.store(false, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < spilled.size(); ++i) {
+            applyMessage(shard, spilled[i]);
+            worked = true;
+        }
+    }
+    return worked;
+}
+
+void DispatchService::applyMessage(Shard& shard, const Message& message) {
+    if (message.type == MessageType::DriverReleased) {
+        // A driver already idle (e.g. with autoReleaseDrivers) must not be queued twice
+        if (shard.driverBusy[message.driverSlot]) {
+            shard.driverBusy[message.driverSlot] = 0;
+            shard.idleDrivers.push_back(message.driverSlot);
+        }
+    } else {
+        message.rider->recordRequest(RidePool::handle(message.ride));
+    }
+    messagesApplied.fetch_add(1, std::memory_order_release);
+}
+
+bool DispatchService::serveOne(Shard& shard) {
+    // Once the shard's ride id stripe is used up its drivers stop taking rides;
+    // other shards keep stealing its queued requests
+    if (shard.idleDrivers.empty() || shard.nextRideSequence >= shard.rideSequenceLimit) {
+        return false;
+    }
+
+    DispatchRequest request;
+    if (!shard.requests.tryPop(request)) {
+        // Own zone is quiet but drivers are idle: help the busiest shard
+        Shard* victim = pickVictim(shard);
+        if (victim == nullptr || !victim->requests.tryPop(request)) {
+            return false;
+        }
+        shard.stolen.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    int driverSlot = shard.idleDrivers.back();
+    shard.idleDrivers.pop_back();
+    shard.driverBusy[driverSlot] = 1;
+    assign(shard, driverSlot, request);
+    return true;
+}
+
+DispatchService::Shard* DispatchService::pickVictim(const Shard& thief) const {
+    Shard* victim = nullptr;
+    std::size_t largest = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        if (shards[i]->index == thief.index) {
+            continue;
+        }
+        std::size_t backlog = shards[i]->requests.sizeApprox();
+        if (backlog > largest) {
+            largest = backlog;
+            victim = shards[i].get();
+        }
+    }
+    return victim;
+}
+
+void DispatchService::assign(Shard& shard, int driverSlot, const DispatchRequest& request) {
+    // Shard-striped ids need no shared counter; serveOne() keeps them within int range
+    int rideID = static_cast<int>(shard.nextRideSequence++ * config.shardCount + shard.index + 1);
+
+    Ride* ride;
+    if (request.type == RideType::Premium) {
+        ride = shard.ridePool.create<PremiumRide>(rideID, request.pickup, request.dropoff, request.distance);
+    } else {
+        ride = shard.ridePool.create<StandardRide>(rideID, request.pickup, request.dropoff, request.distance);
+    }
+    ride->setRequestTime(request.requestTime);
+
+    shard.drivers[driverSlot]->recordRide(RidePool::handle(ride));
+
+    const std::pair<Rider*, int>& rider = riders.find(request.riderID)->second;
+    if (rider.second == shard.index) {
+        rider.first->recordRequest(RidePool::handle(ride));
+    } else {
+        Message message;
+        message.type = MessageType::RideForRider;
+        message.driverSlot = -1;
+        message.rider = rider.first;
+        message.ride = ride;
+        post(*shards[rider.second], message);
+    }
+
+    if (config.autoReleaseDrivers) {
+        shard.driverBusy[driverSlot] = 0;
+        shard.idleDrivers.push_back(driverSlot);
+    }
+    shard.dispatched.fetch_add(1, std::memory_order_release);
+}
+
+void DispatchService::waitUntilDrained() {
+    std::uint64_t lastDispatched = ~std::uint64_t(0);
+    std::chrono::steady_clock::time_point lastProgress = std::chrono::steady_clock::now();
+
+    for (;;) {
+        DispatchStats stats = getStats();
+        bool mailboxesEmpty = messagesApplied.load(std::memory_order_acquire) == messagesPosted.load();
+        if (stats.dispatched == stats.submitted && mailboxesEmpty) {
+            return;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (stats.dispatched != lastDispatched) {
+            lastDispatched = stats.dispatched;
+            lastProgress = now;
+        } else if (mailboxesEmpty && now - lastProgress > std::chrono::milliseconds(200)) {
+            return; // Remaining requests wait for drivers to be released
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+DispatchStats DispatchService::getStats() const {
+    DispatchStats stats;
+    stats.submitted = submitted.load();
+    stats.rejected = rejected.load();
+    stats.dispatched = 0;
+    stats.stolen = 0;
+    for (size_t i = 0; i < shards.size(); ++i) {
+        stats.dispatched += shards[i]->dispatched.load(std::memory_order_acquire);
+        stats.stolen += shards[i]->stolen.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
@@ -0,0 +1,150 @@
+#ifndef DISPATCHSERVICE_H
+#define DISPATCHSERVICE_H
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "BoundedQueue.h"
+#include "Driver.h"
+#include "Rider.h"
+#include "RidePool.h"
+#include "LocationTable.h"
+
+// A ride request as submitted to the dispatch service
+struct DispatchRequest {
+    int riderID;
+    int zone;
+    RideType type;
+    LocationID pickup;
+    LocationID dropoff;
+    double distance;
+    std::time_t requestTime;
+};
+
+struct DispatchConfig {
+    int shardCount;             // One worker thread per shard
+    std::size_t queueCapacity;  // Per-shard request and mailbox capacity
+    bool autoReleaseDrivers;    // Drivers are free again right after an assignment (throughput tests)
+
+    DispatchConfig() : shardCount(4), queueCapacity(1 << 16), autoReleaseDrivers(false) {}
+};
+
+struct DispatchStats {
+    std::uint64_t submitted;
+    std::uint64_t dispatched;
+    std::uint64_t stolen;       // Requests served by a shard other than their zone's
+    std::uint64_t rejected;     // Submissions refused because a queue was full
+};
+
+// Multi-threaded dispatcher. Zones are partitioned into shards, and each shard's worker
+// thread exclusively owns its drivers, its riders and its RidePool, so Driver and Rider
+// need no locking. Requests are queued on their zone's shard; a worker whose queue is
+// empty but who has idle drivers steals from the most backlogged shard, which moves
+// capacity to hot zones during bursts. Cross-shard traffic (stolen requests, ride
+// records for riders homed elsewhere, driver releases) goes through lock-free queues.
+// A message that still finds the target mailbox full after POST_RETRIES attempts is
+// appended to that shard's mutex-guarded overflow list instead, so two workers posting
+// into each other's full mailboxes cannot deadlock.
+//
+// Register drivers and riders before start(); they must not be touched by other
+// threads until stop() returns. Rides live in the shards' RidePools, and drivers and
+// riders only hold non-owning RidePool::handle()s to them: the service must outlive
+// every read of their ride histories.
+class DispatchService {
+private:
+    enum class MessageType {
+        DriverReleased,
+        RideForRider
+    };
+
+    struct Message {
+        MessageType type;
+        int driverSlot;     // DriverReleased: index into the shard's drivers
+        Rider* rider;
+        Ride* ride;
+    };
+
+    static const int POST_RETRIES = 64; // Mailbox attempts before spilling to the overflow list
+
+    struct Shard {
+        int index;
+        BoundedQueue<DispatchRequest> requests; // Stealable by every worker
+        BoundedQueue<Message> mailbox;          // Only drained by the owning worker
+        std::mutex overflowLock;                // Messages that found the mailbox full
+        std::vector<Message> overflow;
+        std::atomic<bool> hasOverflow;
+        std::vector<Driver*> drivers;           // Owner thread only, like the two below
+        std::vector<unsigned char> driverBusy;  // Per slot: on a ride, not in idleDrivers
+        std::vector<int> idleDrivers;           // Slots
+        RidePool ridePool;                      // Owner thread only
+        std::uint64_t nextRideSequence;
+        std::uint64_t rideSequenceLimit;        // Sequences whose striped id fits in an int
+        std::atomic<std::uint64_t> dispatched;
+        std::atomic<std::uint64_t> stolen;
+
+        Shard(int shardIndex, int shardCount, std::size_t capacity)
+            : index(shardIndex), requests(capacity), mailbox(capacity), hasOverflow(false), nextRideSequence(0),
+              rideSequenceLimit((static_cast<std::uint64_t>(INT_MAX) - 1 - shardIndex) / shardCount + 1),
+              dispatched(0), stolen(0) {
+        }
+    };
+
+    DispatchConfig config;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<std::thread> workers;
+    std::unordered_map<int, std::pair<Rider*, int>> riders;   // riderID -> (rider, home shard)
+    std::unordered_map<int, std::pair<int, int>> driverSlots;   // driverID -> (shard, slot)
+    std::atomic<bool> running;
+    std::atomic<std::uint64_t> submitted;
+    std::atomic<std::uint64_t> rejected;
+    std::atomic<std::uint64_t> messagesPosted;
+    std::atomic<std::uint64_t> messagesApplied;
+
+    int shardForZone(int zone) const;
+    void workerLoop(Shard& shard);
+    bool drainMailbox(Shard& shard);
+    void applyMessage(Shard& shard, const Message& message);
+    bool serveOne(Shard& shard);
+    Shard* pickVictim(const Shard& thief) const;
+    void assign(Shard& shard, int driverSlot, const DispatchRequest& request);
+    void post(Shard& target, const Message& message);
+
+    DispatchService(const DispatchService&);            // Non-copyable
+    DispatchService& operator=(const DispatchService&);
+
+public:
+    // Constructor
+    explicit DispatchService(const DispatchConfig& dispatchConfig = DispatchConfig());
+
+    // Destructor stops the workers
+    ~DispatchService();
+
+    // Registration (before start)
+    void addDriver(Driver& driver, int zone);
+    void addRider(Rider& rider, int homeZone);
+
+    // Worker lifecycle
+    void start();
+    void stop();
+
+    // Thread-safe; returns false if the zone's queue is full
+    bool submit(const DispatchRequest& request);
+
+    // Thread-safe; hands a driver who finished a trip back to its shard. Releasing a
+    // driver who is already idle is ignored. Returns false for an unknown driver or
+    // when the service is not running.
+    bool releaseDriver(int driverID);
+
+    // Block until every submitted request is dispatched, or no progress is possible
+    void waitUntilDrained();
+
+    DispatchStats getStats() const;
+};
+
+#endif // DISPATCHSERVICE_H
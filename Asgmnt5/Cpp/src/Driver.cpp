@@ -1,55 +1,159 @@
 #include "Driver.h"
+#include "DriverLeaderboard.h"
 
 Driver::Driver(int id, const std::string& driverName, double initialRating)
-    : driverID(id), name(driverName), rating(initialRating) {
+    : driverID(id), name(driverName), rating(initialRating), leaderboard(nullptr) {
+}
+
+Driver::Driver(const Driver& other)
+    : driverID(other.driverID), name(other.name), rating(other.rating), assignedRides(other.assignedRides),
+      earnings(other.earnings), leaderboard(nullptr) {
+}
+
+Driver::Driver(Driver&& other) noexcept
+    : driverID(other.driverID), name(std::move(other.name)), rating(other.rating),
+      assignedRides(std::move(other.assignedRides)), earnings(std::move(other.earnings)), leaderboard(nullptr) {
+    if (other.leaderboard) {
+        DriverLeaderboard* board = other.leaderboard;
+        other.leaderboard = nullptr;
+        board->track(*this);
+    }
+}
+
+Driver& Driver::operator=(const Driver& other) {
+    if (this != &other) {
+        if (leaderboard) {
+            leaderboard->untrack(*this);
+        }
+        driverID = other.driverID;
+        name = other.name;
+        rating = other.rating;
+        assignedRides = other.assignedRides;
+        earnings = other.earnings;
+    }
+    return *this;
+}
+
+Driver& Driver::operator=(Driver&& other) noexcept {
+    if (this != &other) {
+        if (leaderboard) {
+            leaderboard->untrack(*this);
+        }
+        driverID = other.driverID;
+        name = std::move(other.name);
+        rating = other.rating;
+        assignedRides = std::move(other.assignedRides);
+        earnings = std::move(other.earnings);
+        if (other.leaderboard) {
+            DriverLeaderboard* board = other.leaderboard;
+            other.leaderboard = nullptr;
+            board->track(*this);
+        }
+    }
+    return *this;
+}
+
+Driver::~Driver() {
+    if (leaderboard) {
+        leaderboard->untrack(*this);
+    }
 }
 
 void Driver::addRide(std::shared_ptr<Ride> ride) {
     if (ride) {
-        assignedRides.push_back(ride);
+        recordRide(ride);
         std::cout << "Ride " << ride->getRideID() << " assigned to driver " << name << std::endl;
     }
 }
 
+void Driver::recordRide(std::shared_ptr<Ride> ride) {
+    if (ride) {
+        ride->setDriverIndex(static_cast<std::uint32_t>(assignedRides.size()));
+        assignedRides.push_back(ride);
+        ride->markFareRecorded();
+        earnings.addFare(ride->getRideType(), ride->fare());
+        if (leaderboard) {
+            leaderboard->update(*this);
+        }
+    }
+}
+
+void Driver::replayRide(RideType type, double fare) {
+    earnings.addFare(type, fare);
+    if (leaderboard) {
+        leaderboard->update(*this);
+    }
+}
+
+std::shared_ptr<Ride> Driver::removeRideAt(size_t index) {
+    // Swap with the last ride and pop, so removal never shifts the history
+    std::shared_ptr<Ride> ride = assignedRides[index];
+    if (index + 1 != assignedRides.size()) {
+        assignedRides[index] = assignedRides.back();
+        assignedRides[index]->setDriverIndex(static_cast<std::uint32_t>(index));
+    }
+    assignedRides.pop_back();
+    earnings.removeFare(ride->getRideType(), ride->fare());
+    if (earnings.needsExtremesRebuild()) {
+        earnings.rebuildExtremes(viewAssignedRides());
+    }
+    if (leaderboard) {
+        leaderboard->update(*this);
+    }
+    return ride;
+}
+
+std::shared_ptr<Ride> Driver::removeRide(const Ride& ride) {
+    size_t index = ride.getDriverIndex();
+    if (index < assignedRides.size() && assignedRides[index].get() == &ride) {
+        return removeRideAt(index);
+    }
+    return removeRide(ride.getRideID()); // Recorded by more than one driver: its index is another's
+}
+
+std::shared_ptr<Ride> Driver::removeRide(int rideID) {
+    for (size_t i = assignedRides.size(); i-- > 0;) {
+        if (assignedRides[i]->getRideID() == rideID) {
+            return removeRideAt(i);
+        }
+    }
+    return std::shared_ptr<Ride>();
+}
+
 void Driver::getDriverInfo() const {
     std::cout << "\n=== Driver Information ===" << std::endl;
     std::cout << "Driver ID: " << driverID << std::endl;
     std::cout << "Name: " << name << std::endl;
     std::cout << "Rating: " << rating << "/5.0" << std::endl;
-    std::cout << "Total Rides Completed: " << assignedRides.size() << std::endl;
+    std::cout << "Total Rides Completed: " << earnings.getCount() << std::endl;
     std::cout << "Total Earnings: $" << calculateTotalEarnings() << std::endl;
     std::cout << "=========================" << std::endl;
 }
 
 std::vector<std::shared_ptr<Ride>> Driver::getAssignedRides() const {
-    return assignedRides; // Returns a copy, maintaining encapsulation
+    return assignedRides; // Returns a copy; prefer viewAssignedRides() to avoid it
 }
 
-void Driver::displayRideHistory() const {
-    std::cout << "\n=== Ride History for " << name << " ===" << std::endl;
+void Driver::displayRideHistory(std::ostream& out) const {
+    out << "\n=== Ride History for " << name << " ===\n";
     if (assignedRides.empty()) {
-        std::cout << "No rides completed yet." << std::endl;
+        out << "No rides completed yet.\n";
     } else {
         for (size_t i = 0; i < assignedRides.size(); ++i) {
-            std::cout << "\nRide " << (i + 1) << ":" << std::endl;
-            assignedRides[i]->rideDetails();
+            out << "\nRide " << (i + 1) << ":\n";
+            assignedRides[i]->rideDetails(out);
         }
     }
-    std::cout << "=================================" << std::endl;
+    out << "=================================\n";
 }
 
 void Driver::setRating(double newRating) {
     if (newRating >= 0.0 && newRating <= 5.0) {
         rating = newRating;
+        if (leaderboard) {
+            leaderboard->update(*this);
+        }
     } else {
         std::cout << "Invalid rating. Must be between 0.0 and 5.0" << std::endl;
     }
-}
-
-double Driver::calculateTotalEarnings() const {
-    double total = 0.0;
-    for (const auto& ride : assignedRides) {
-        total += ride->fare();
-    }
-    return total;
 }
\ No newline at end of file
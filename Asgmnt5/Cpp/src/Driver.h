@@ -6,6 +6,10 @@
 #include <memory>
 #include <iostream>
 #include "Ride.h"
+#include "RideView.h"
+#include "FareStats.h"
+
+class DriverLeaderboard;
 
 class Driver {
 private:
@@ -13,31 +17,67 @@ private:
     std::string name;
     double rating;
     std::vector<std::shared_ptr<Ride>> assignedRides; // Encapsulated - private member
+    FareStats earnings; // Running aggregates, updated on every addRide
+    DriverLeaderboard* leaderboard; // Notified of rating and earnings changes, if tracked
+
+    std::shared_ptr<Ride> removeRideAt(size_t index);
 
 public:
     // Constructor
     Driver(int id, const std::string& driverName, double initialRating = 5.0);
     
-    // Destructor
-    ~Driver() = default;
+    // Copies start untracked; a move hands the leaderboard over to the new object
+    Driver(const Driver& other);
+    Driver(Driver&& other) noexcept;
+    Driver& operator=(const Driver& other);
+    Driver& operator=(Driver&& other) noexcept;
+    
+    // Destructor untracks the driver from its leaderboard
+    ~Driver();
     
     // Public methods to interact with private assignedRides (Encapsulation)
     void addRide(std::shared_ptr<Ride> ride);
+    void recordRide(std::shared_ptr<Ride> ride); // Same as addRide() without console output
+    void replayRide(RideType type, double fare); // Restore aggregates from a persisted ride (e.g. RideJournal)
+    // Cancel/reassign: drop from history and aggregates; null if absent. The last ride
+    // takes the removed one's place, so history order is not preserved. Removing the
+    // lowest or highest fare rebuilds the fare extremes from the history in O(n).
+    std::shared_ptr<Ride> removeRide(const Ride& ride); // O(1) unless the extremes are rebuilt
+    std::shared_ptr<Ride> removeRide(int rideID);       // Searches the history
     void getDriverInfo() const;
     std::vector<std::shared_ptr<Ride>> getAssignedRides() const;
-    void displayRideHistory() const;
+    void displayRideHistory(std::ostream& out = std::cout) const;
+    
+    // Non-copying access to the ride history
+    RideRange viewAssignedRides() const { return RideRange(assignedRides.begin(), assignedRides.end()); }
+    FilteredRideRange filterAssignedRides(const RideFilter& filter) const {
+        return FilteredRideRange(assignedRides.begin(), assignedRides.end(), filter);
+    }
+    
+    // Invoke callback(const Ride&) for every ride in the history
+    template <typename Callback>
+    void forEachAssignedRide(Callback callback) const {
+        for (size_t i = 0; i < assignedRides.size(); ++i) {
+            callback(*assignedRides[i]);
+        }
+    }
     
     // Getter methods
     int getDriverID() const { return driverID; }
     std::string getName() const { return name; }
     double getRating() const { return rating; }
-    int getTotalRides() const { return assignedRides.size(); }
+    int getTotalRides() const { return earnings.getCount(); } // Includes replayed rides
     
     // Setter methods
     void setRating(double newRating);
     
-    // Calculate total earnings
-    double calculateTotalEarnings() const;
+    // Leaderboard ranking this driver; set by DriverLeaderboard::track()/untrack()
+    DriverLeaderboard* getLeaderboard() const { return leaderboard; }
+    void setLeaderboard(DriverLeaderboard* board) { leaderboard = board; }
+    
+    // Total earnings, kept up to date incrementally (O(1))
+    double calculateTotalEarnings() const { return earnings.getTotal(); }
+    const FareStats& getEarningsStats() const { return earnings; }
 };
 
 #endif // DRIVER_H
\ No newline at end of file
@@ -0,0 +1,314 @@
+#include "DriverLeaderboard.h"
+#include <algorithm>
+#include "Driver.h"
+
+DriverLeaderboard::RankTree::RankTree() : root(NIL), priorityState(0x9E3779B9u) {
+}
+
+std::uint32_t DriverLeaderboard::RankTree::nextPriority() {
+    // xorshift32; treap balance only needs the priorities to look random
+    priorityState ^= priorityState << 13;
+    priorityState ^= priorityState >> 17;
+    priorityState ^= priorityState << 5;
+    return priorityState;
+}
+
+std::int32_t DriverLeaderboard::RankTree::allocate(double score, int driverID) {
+    std::int32_t node;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+    } else {
+        node = static_cast<std::int32_t>(nodes.size());
+        nodes.push_back(Node());
+    }
+    Node& fresh = nodes[node];
+    fresh.score = score;
+    fresh.driverID = driverID;
+    fresh.priority = nextPriority();
+    fresh.left = NIL;
+    fresh.right = NIL;
+    fresh.size = 1;
+    return node;
+}
+
+// Split into entries ordered before (score, driverID) and the rest
+void DriverLeaderboard::RankTree::split(std::int32_t node, double score, int driverID,
+                                        std::int32_t& left, std::int32_t& right) {
+    if (node == NIL) {
+        left = NIL;
+        right = NIL;
+        return;
+    }
+    if (before(nodes[node].score, nodes[node].driverID, score, driverID)) {
+        split(nodes[node].right, score, driverID, nodes[node].right, right);
+        left = node;
+    } else {
+        split(nodes[node].left, score, driverID, left, nodes[node].left);
+        right = node;
+    }
+    refresh(node);
+}
+
+std::int32_t DriverLeaderboard::RankTree::merge(std::int32_t left, std::int32_t right) {
+    if (left == NIL) {
+        return right;
+    }
+    if (right == NIL) {
+        return left;
+    }
+    if (nodes[left].priority > nodes[right].priority) {
+        nodes[left].right = merge(nodes[left].right, right);
+        refresh(left);
+        return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    refresh(right);
+    return right;
+}
+
+std::int32_t DriverLeaderboard::RankTree::insertAt(std::int32_t node, std::int32_t fresh) {
+    if (node == NIL) {
+        return fresh;
+    }
+    if (nodes[fresh].priority > nodes[node].priority) {
+        split(node, nodes[fresh].score, nodes[fresh].driverID, nodes[fresh].left, nodes[fresh].right);
+        refresh(fresh);
+        return fresh;
+    }
+    if (before(nodes[fresh].score, nodes[fresh].driverID, nodes[node].score, nodes[node].driverID)) {
+        nodes[node].left = insertAt(nodes[node].left, fresh);
+    } else {
+        nodes[node].right = insertAt(nodes[node].right, fresh);
+    }
+    refresh(node);
+    return node;
+}
+
+std::int32_t DriverLeaderboard::RankTree::eraseAt(std::int32_t node, double score, int driverID) {
+    if (node == NIL) {
+        return NIL;
+    }
+    if (nodes[node].driverID == driverID && nodes[node].score == score) {
+        std::int32_t replacement = merge(nodes[node].left, nodes[node].right);
+        freeNodes.push_back(node);
+        return replacement;
+    }
+    if (before(score, driverID, nodes[node].score, nodes[node].driverID)) {
+        nodes[node].left = eraseAt(nodes[node].left, score, driverID);
+    } else {
+        nodes[node].right = eraseAt(nodes[node].right, score, driverID);
+    }
+    refresh(node);
+    return node;
+}
+
+void DriverLeaderboard::RankTree::insert(double score, int driverID) {
+    std::int32_t fresh = allocate(score, driverID);
+    root = insertAt(root, fresh);
+}
+
+void DriverLeaderboard::RankTree::erase(double score, int driverID) {
+    root = eraseAt(root, score, driverID);
+}
+
+std::size_t DriverLeaderboard::RankTree::countBefore(double score, int driverID) const {
+    std::size_t count = 0;
+    std::int32_t node = root;
+    while (node != NIL) {
+        if (before(nodes[node].score, nodes[node].driverID, score, driverID)) {
+            count += sizeOf(nodes[node].left) + 1;
+            node = nodes[node].right;
+        } else {
+            node = nodes[node].left;
+        }
+    }
+    return count;
+}
+
+LeaderboardEntry DriverLeaderboard::RankTree::at(std::size_t position) const {
+    std::int32_t node = root;
+    while (node != NIL) {
+        std::size_t leftSize = static_cast<std::size_t>(sizeOf(nodes[node].left));
+        if (position < leftSize) {
+            node = nodes[node].left;
+        } else if (position == leftSize) {
+            break;
+        } else {
+            position -= leftSize + 1;
+            node = nodes[node].right;
+        }
+    }
+    LeaderboardEntry entry;
+    entry.driverID = node == NIL ? 0 : nodes[node].driverID;
+    entry.score = node == NIL ? 0.0 : nodes[node].score;
+    return entry;
+}
+
+void DriverLeaderboard::RankTree::first(std::size_t k, std::vector<LeaderboardEntry>& out) const {
+    // In-order walk that stops after k entries
+    std::vector<std::int32_t> stack;
+    std::int32_t node = root;
+    while ((node != NIL || !stack.empty()) && out.size() < k) {
+        while (node != NIL) {
+            stack.push_back(node);
+            node = nodes[node].left;
+        }
+        node = stack.back();
+        stack.pop_back();
+        LeaderboardEntry entry;
+        entry.driverID = nodes[node].driverID;
+        entry.score = nodes[node].score;
+        out.push_back(entry);
+        node = nodes[node].right;
+    }
+}
+
+DriverLeaderboard::DriverLeaderboard() {
+}
+
+DriverLeaderboard::~DriverLeaderboard() {
+    for (std::unordered_map<int, Driver*>::iterator it = members.begin(); it != members.end(); ++it) {
+        if (it->second->getLeaderboard() == this) {
+            it->second->setLeaderboard(nullptr);
+        }
+    }
+}
+
+DriverLeaderboard::Scores DriverLeaderboard::scoresOf(const Driver& driver) {
+    Scores current;
+    current.values[static_cast<int>(Metric::Rating)] = driver.getRating();
+    current.values[static_cast<int>(Metric::Earnings)] = driver.calculateTotalEarnings();
+    return current;
+}
+
+void DriverLeaderboard::track(Driver& driver) {
+    driver.setLeaderboard(this);
+    Scores current = scoresOf(driver);
+
+    std::lock_guard<std::mutex> guard(lock);
+    members[driver.getDriverID()] = &driver;
+    applyPending();
+    place(driver.getDriverID(), current);
+}
+
+void DriverLeaderboard::untrack(Driver& driver) {
+    if (driver.getLeaderboard() == this) {
+        driver.setLeaderboard(nullptr);
+    }
+    int driverID = driver.getDriverID();
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::unordered_map<int, Driver*>::iterator member = members.find(driverID);
+    if (member == members.end() || member->second != &driver) {
+        return; // Not tracked, or only a copy of a tracked driver
+    }
+    members.erase(member);
+    {
+        PendingShard& shard = shardOf(driverID);
+        std::lock_guard<std::mutex> shardGuard(shard.lock);
+        shard.scores.erase(driverID);
+    }
+    std::unordered_map<int, Scores>::iterator it = scores.find(driverID);
+    if (it == scores.end()) {
+        return;
+    }
+    for (int m = 0; m < METRIC_COUNT; ++m) {
+        trees[m].erase(it->second.values[m], it->first);
+    }
+    scores.erase(it);
+}
+
+void DriverLeaderboard::update(const Driver& driver) {
+    Scores current = scoresOf(driver);
+    PendingShard& shard = shardOf(driver.getDriverID());
+    std::lock_guard<std::mutex> guard(shard.lock);
+    shard.scores[driver.getDriverID()] = current; // Replaces any change not yet applied
+}
+
+void DriverLeaderboard::applyPending() const {
+    std::unordered_map<int, Scores> batch;
+    for (int s = 0; s < PENDING_SHARDS; ++s) {
+        {
+            std::lock_guard<std::mutex> guard(pending[s].lock);
+            batch.swap(pending[s].scores);
+        }
+        for (std::unordered_map<int, Scores>::const_iterator it = batch.begin(); it != batch.end(); ++it) {
+            if (members.count(it->first) != 0) {
+                place(it->first, it->second);
+            }
+        }
+        batch.clear();
+    }
+}
+
+void DriverLeaderboard::place(int driverID, const Scores& current) const {
+    std::unordered_map<int, Scores>::iterator it = scores.find(driverID);
+    if (it == scores.end()) {
+        for (int m = 0; m < METRIC_COUNT; ++m) {
+            trees[m].insert(current.values[m], driverID);
+        }
+        scores.insert(std::make_pair(driverID, current));
+        return;
+    }
+
+    for (int m = 0; m < METRIC_COUNT; ++m) {
+        if (it->second.values[m] != current.values[m]) {
+            trees[m].erase(it->second.values[m], driverID);
+            trees[m].insert(current.values[m], driverID);
+        }
+    }
+    it->second = current;
+}
+
+std::vector<LeaderboardEntry> DriverLeaderboard::topK(Metric metric, std::size_t k) const {
+    std::vector<LeaderboardEntry> top;
+    std::lock_guard<std::mutex> guard(lock);
+    applyPending();
+    top.reserve(std::min(k, scores.size()));
+    trees[static_cast<int>(metric)].first(k, top);
+    return top;
+}
+
+int DriverLeaderboard::rankOf(Metric metric, int driverID) const {
+    std::lock_guard<std::mutex> guard(lock);
+    applyPending();
+    std::unordered_map<int, Scores>::const_iterator it = scores.find(driverID);
+    if (it == scores.end()) {
+        return 0;
+    }
+    int m = static_cast<int>(metric);
+    return static_cast<int>(trees[m].countBefore(it->second.values[m], driverID)) + 1;
+}
+
+bool DriverLeaderboard::entryAtRank(Metric metric, std::size_t rank, LeaderboardEntry& entry) const {
+    std::lock_guard<std::mutex> guard(lock);
+    applyPending();
+    if (rank < 1 || rank > scores.size()) {
+        return false;
+    }
+    entry = trees[static_cast<int>(metric)].at(rank - 1);
+    return true;
+}
+
+double DriverLeaderboard::percentileOf(Metric metric, int driverID) const {
+    std::lock_guard<std::mutex> guard(lock);
+    applyPending();
+    std::unordered_map<int, Scores>::const_iterator it = scores.find(driverID);
+    if (it == scores.end()) {
+        return -1.0;
+    }
+    std::size_t total = scores.size();
+    if (total == 1) {
+        return 100.0;
+    }
+    int m = static_cast<int>(metric);
+    std::size_t below = total - 1 - trees[m].countBefore(it->second.values[m], driverID);
+    return 100.0 * below / (total - 1);
+}
+
+std::size_t DriverLeaderboard::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    applyPending();
+    return scores.size();
+}
@@ -0,0 +1,135 @@
+#ifndef DRIVERLEADERBOARD_H
+#define DRIVERLEADERBOARD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class Driver;
+
+struct LeaderboardEntry {
+    int driverID;
+    double score;
+};
+
+// Live ranking of drivers by rating and by total earnings.
+// Each metric is an order-statistic tree (a treap whose nodes count their subtree), so
+// updates, rank-of-driver, rank lookups and percentiles are O(log n) and top-K is
+// O(log n + k). Tracked drivers push their own changes from setRating() and every
+// recorded ride, so the board is never rebuilt by scanning drivers.
+//
+// Thread-safe. A change only stores the driver's latest scores in one of several
+// pending shards, each with its own lock, so concurrent rides rarely contend; the
+// trees apply the pending scores in a batch on the next query, once per changed driver.
+// A driver untracks itself when destroyed, and a destroyed board detaches its drivers.
+class DriverLeaderboard {
+public:
+    enum class Metric {
+        Rating,
+        Earnings
+    };
+
+private:
+    static const int METRIC_COUNT = 2;
+    static const int PENDING_SHARDS = 16;
+    static const std::int32_t NIL = -1;
+
+    struct Node {
+        double score;
+        int driverID;
+        std::uint32_t priority;
+        std::int32_t left;
+        std::int32_t right;
+        std::int32_t size;  // Nodes in this subtree
+    };
+
+    // Order: higher score first, ties by lower driver id
+    class RankTree {
+    private:
+        std::vector<Node> nodes;
+        std::vector<std::int32_t> freeNodes;
+        std::int32_t root;
+        std::uint32_t priorityState;
+
+        static bool before(double scoreA, int idA, double scoreB, int idB) {
+            return scoreA > scoreB || (scoreA == scoreB && idA < idB);
+        }
+        std::int32_t sizeOf(std::int32_t node) const { return node == NIL ? 0 : nodes[node].size; }
+        void refresh(std::int32_t node) {
+            nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right);
+        }
+        std::uint32_t nextPriority();
+        std::int32_t allocate(double score, int driverID);
+        void split(std::int32_t node, double score, int driverID, std::int32_t& left, std::int32_t& right);
+        std::int32_t merge(std::int32_t left, std::int32_t right);
+        std::int32_t insertAt(std::int32_t node, std::int32_t fresh);
+        std::int32_t eraseAt(std::int32_t node, double score, int driverID);
+
+    public:
+        RankTree();
+
+        void insert(double score, int driverID);
+        void erase(double score, int driverID);
+        std::size_t size() const { return static_cast<std::size_t>(sizeOf(root)); }
+
+        // Number of entries ordered before (score, driverID)
+        std::size_t countBefore(double score, int driverID) const;
+        // Entry at a 0-based position
+        LeaderboardEntry at(std::size_t position) const;
+        // First k entries in order
+        void first(std::size_t k, std::vector<LeaderboardEntry>& out) const;
+    };
+
+    struct Scores {
+        double values[METRIC_COUNT];
+    };
+
+    // Latest scores of drivers changed since the last query
+    struct PendingShard {
+        std::mutex lock;
+        std::unordered_map<int, Scores> scores;
+    };
+
+    // The trees only change under lock, from track/untrack or when a query applies pending scores
+    mutable RankTree trees[METRIC_COUNT];
+    mutable std::unordered_map<int, Scores> scores; // driverID -> scores currently in the trees
+    std::unordered_map<int, Driver*> members;       // Tracked drivers, detached on destruction
+    mutable PendingShard pending[PENDING_SHARDS];
+    mutable std::mutex lock;                        // Taken before any pending shard lock
+
+    static Scores scoresOf(const Driver& driver);
+    PendingShard& shardOf(int driverID) const {
+        return pending[static_cast<unsigned>(driverID) % PENDING_SHARDS];
+    }
+    void applyPending() const; // Caller holds lock
+    void place(int driverID, const Scores& current) const;
+
+    DriverLeaderboard(const DriverLeaderboard&);            // Non-copyable
+    DriverLeaderboard& operator=(const DriverLeaderboard&);
+
+public:
+    // Constructor
+    DriverLeaderboard();
+
+    // Destructor detaches every tracked driver
+    ~DriverLeaderboard();
+
+    // Start or stop ranking a driver; tracked drivers report their own updates.
+    // track() also re-points the board at a driver that moved (called by Driver).
+    void track(Driver& driver);
+    void untrack(Driver& driver);
+
+    // Queue a re-rank after a driver's rating or earnings changed (called by Driver)
+    void update(const Driver& driver);
+
+    // Queries; ranks are 1-based, 1 being the best
+    std::vector<LeaderboardEntry> topK(Metric metric, std::size_t k) const;
+    int rankOf(Metric metric, int driverID) const;              // 0 if not tracked
+    bool entryAtRank(Metric metric, std::size_t rank, LeaderboardEntry& entry) const;
+    double percentileOf(Metric metric, int driverID) const;     // Share of drivers ranked below, 0-100; -1 if not tracked
+    std::size_t size() const;
+};
+
+#endif // DRIVERLEADERBOARD_H
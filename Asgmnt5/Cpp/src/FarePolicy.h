@@ -0,0 +1,95 @@
+#ifndef FAREPOLICY_H
+#define FAREPOLICY_H
+
+#include <cstddef>
+#include "Ride.h"
+#include "LocationTable.h"
+
+// Compile-time fare schedule, one specialization per RideType.
+// StandardRide and PremiumRide take their rates from here, so the virtual fare()
+// and the statically dispatched functions below always agree.
+// To add a tier: extend RideType, specialize FarePolicy and add a FARE_TABLE row.
+template <RideType Type>
+struct FarePolicy;
+
+template <>
+struct FarePolicy<RideType::Standard> {
+    static constexpr double baseFare() { return RIDE_BASE_FARE; }
+    static constexpr double ratePerMile() { return 1.5; }
+    static constexpr double surcharge() { return 0.0; }
+    static constexpr double fare(double distance, double surge = 1.0) {
+        return (baseFare() + distance * ratePerMile()) * surge + surcharge();
+    }
+};
+
+template <>
+struct FarePolicy<RideType::Premium> {
+    static constexpr double baseFare() { return RIDE_BASE_FARE; }
+    static constexpr double ratePerMile() { return 2.5; }
+    static constexpr double surcharge() { return 5.0; }
+    static constexpr double fare(double distance, double surge = 1.0) {
+        return (baseFare() + distance * ratePerMile()) * surge + surcharge();
+    }
+};
+
+// Rate table indexed by RideType, built from the policies above
+struct FareRates {
+    double baseFare;
+    double ratePerMile;
+    double surcharge;
+};
+
+constexpr FareRates FARE_TABLE[RIDE_TYPE_COUNT] = {
+    { FarePolicy<RideType::Standard>::baseFare(), FarePolicy<RideType::Standard>::ratePerMile(),
+      FarePolicy<RideType::Standard>::surcharge() },
+    { FarePolicy<RideType::Premium>::baseFare(), FarePolicy<RideType::Premium>::ratePerMile(),
+      FarePolicy<RideType::Premium>::surcharge() }
+};
+
+// Tag-dispatched fare via the rate table; inlinable, unlike the virtual Ride::fare().
+// Surge scales the metered part (base + distance); surcharges stay flat.
+inline double staticFare(RideType type, double distance, double surge = 1.0) {
+    const FareRates& rates = FARE_TABLE[static_cast<int>(type)];
+    return (rates.baseFare + distance * rates.ratePerMile) * surge + rates.surcharge;
+}
+
+// Closed-set ride stored by value: no vtable, no heap allocation
+struct RideRecord {
+    int rideID;
+    RideType type;
+    LocationID pickup;
+    LocationID dropoff;
+    double distance;
+    double surgeMultiplier;
+
+    double fare() const { return staticFare(type, distance, surgeMultiplier); }
+};
+
+// Convert from the class hierarchy
+inline RideRecord makeRideRecord(const Ride& ride) {
+    RideRecord record;
+    record.rideID = ride.getRideID();
+    record.type = ride.getRideType();
+    record.pickup = ride.getPickupID();
+    record.dropoff = ride.getDropoffID();
+    record.distance = ride.getDistance();
+    record.surgeMultiplier = ride.getSurgeMultiplier();
+    return record;
+}
+
+// Bulk pricing of mixed ride types, branch-free table lookups
+inline void computeFares(const RideRecord* rides, std::size_t count, double* fares) {
+    for (std::size_t i = 0; i < count; ++i) {
+        fares[i] = rides[i].fare();
+    }
+}
+
+// Bulk pricing of a single tier; a plain multiply-add loop the compiler can vectorize
+template <RideType Type>
+inline void computeFares(const double* distances, std::size_t count, double* fares) {
+    for (std::size_t i = 0; i < count; ++i) {
+        fares[i] = FarePolicy<Type>::fare(distances[i]);
+    }
+}
+
+#endif // FAREPOLICY_H
@@ -0,0 +1,71 @@
+#include "FareStats.h"
+#include <cmath>
+#include <limits>
+
+void FareStats::CompensatedSum::add(double value) {
+    // Neumaier variant of Kahan summation: also exact when value dominates sum
+    double t = sum + value;
+    if (std::fabs(sum) >= std::fabs(value)) {
+        compensation += (sum - t) + value;
+    } else {
+        compensation += (value - t) + sum;
+    }
+    sum = t;
+}
+
+FareStats::FareStats() {
+    reset();
+}
+
+void FareStats::reset() {
+    total = CompensatedSum();
+    count = 0;
+    for (int i = 0; i < RIDE_TYPE_COUNT; ++i) {
+        typeTotals[i] = CompensatedSum();
+        typeCounts[i] = 0;
+    }
+    resetExtremes();
+    extremesStale = false;
+}
+
+void FareStats::resetExtremes() {
+    minFare = std::numeric_limits<double>::max();
+    maxFare = -std::numeric_limits<double>::max();
+}
+
+void FareStats::includeExtreme(double fare) {
+    if (fare < minFare) {
+        minFare = fare;
+    }
+    if (fare > maxFare) {
+        maxFare = fare;
+    }
+}
+
+void FareStats::addFare(RideType type, double fare) {
+    int index = static_cast<int>(type);
+    total.add(fare);
+    typeTotals[index].add(fare);
+    ++count;
+    ++typeCounts[index];
+    includeExtreme(fare);
+}
+
+void FareStats::removeFare(RideType type, double fare) {
+    int index = static_cast<int>(type);
+    if (count == 0 || typeCounts[index] == 0) {
+        std::cout << "Cannot remove fare: no rides of this type recorded" << std::endl;
+        return;
+    }
+
+    total.add(-fare);
+    typeTotals[index].add(-fare);
+    --count;
+    --typeCounts[index];
+
+    if (count == 0) {
+        reset();
+    } else if (fare <= minFare || fare >= maxFare) {
+        extremesStale = true;
+    }
+}
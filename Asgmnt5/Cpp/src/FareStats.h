@@ -0,0 +1,63 @@
+#ifndef FARESTATS_H
+#define FARESTATS_H
+
+#include "Ride.h"
+
+// Running fare aggregates (total, count, per-type totals, mean/min/max).
+// Updated once per ride instead of re-summing a history, so every query is O(1).
+// Sums use Neumaier compensated summation so long add/remove sequences do not drift.
+class FareStats {
+private:
+    struct CompensatedSum {
+        double sum;
+        double compensation;
+
+        CompensatedSum() : sum(0.0), compensation(0.0) {}
+        void add(double value);
+        double value() const { return sum + compensation; }
+    };
+
+    CompensatedSum total;
+    CompensatedSum typeTotals[RIDE_TYPE_COUNT];
+    int count;
+    int typeCounts[RIDE_TYPE_COUNT];
+    double minFare;
+    double maxFare;
+    bool extremesStale; // Set when a removed fare was the current min or max
+
+public:
+    // Constructor
+    FareStats();
+
+    // Record a new fare, or take one back out (ride cancellation)
+    void addFare(RideType type, double fare);
+    void removeFare(RideType type, double fare);
+
+    // Removing an extreme leaves min/max unknown until the owner rescans its rides
+    bool needsExtremesRebuild() const { return extremesStale; }
+    template <typename RideRangeType>
+    void rebuildExtremes(const RideRangeType& rides) {
+        resetExtremes();
+        for (const Ride& ride : rides) {
+            includeExtreme(ride.fare());
+        }
+        extremesStale = false;
+    }
+
+    // Getter methods
+    double getTotal() const { return total.value(); }
+    int getCount() const { return count; }
+    double getTotalFor(RideType type) const { return typeTotals[static_cast<int>(type)].value(); }
+    int getCountFor(RideType type) const { return typeCounts[static_cast<int>(type)]; }
+    double getMean() const { return count > 0 ? total.value() / count : 0.0; }
+    double getMin() const { return count > 0 ? minFare : 0.0; }
+    double getMax() const { return count > 0 ? maxFare : 0.0; }
+
+    void reset();
+
+private:
+    void resetExtremes();
+    void includeExtreme(double fare);
+};
+
+#endif // FARESTATS_H
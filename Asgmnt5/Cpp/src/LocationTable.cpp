@@ -0,0 +1,56 @@
+#include "LocationTable.h"
+#include <iostream>
+
+const std::string LocationTable::UNKNOWN_NAME = "Unknown location";
+
+LocationTable::LocationTable() : count(0) {
+    for (std::size_t i = 0; i < MAX_CHUNKS; ++i) {
+        chunks[i] = nullptr;
+    }
+}
+
+LocationTable::~LocationTable() {
+    for (std::size_t i = 0; i < MAX_CHUNKS; ++i) {
+        delete[] chunks[i];
+    }
+}
+
+LocationTable& LocationTable::global() {
+    static LocationTable table;
+    return table;
+}
+
+LocationID LocationTable::intern(const std::string& name) {
+    std::lock_guard<std::mutex> guard(internLock);
+
+    std::unordered_map<std::string, LocationID>::const_iterator it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    std::uint32_t id = count.load(std::memory_order_relaxed);
+    std::size_t chunk = id >> CHUNK_BITS;
+    if (chunk >= MAX_CHUNKS) {
+        std::cout << "Location table is full, cannot add: " << name << std::endl;
+        return INVALID_LOCATION;
+    }
+    if (chunks[chunk] == nullptr) {
+        chunks[chunk] = new std::string[CHUNK_SIZE];
+    }
+
+    chunks[chunk][id & (CHUNK_SIZE - 1)] = name;
+    ids.insert(std::make_pair(name, id));
+    count.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+bool LocationTable::find(const std::string& name, LocationID& id) const {
+    std::lock_guard<std::mutex> guard(internLock);
+
+    std::unordered_map<std::string, LocationID>::const_iterator it = ids.find(name);
+    if (it == ids.end()) {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
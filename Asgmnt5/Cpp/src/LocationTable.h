@@ -0,0 +1,63 @@
+#ifndef LOCATIONTABLE_H
+#define LOCATIONTABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+typedef std::uint32_t LocationID;
+
+// Returned by intern() when the table is full; never a valid id
+const LocationID INVALID_LOCATION = ~LocationID(0);
+
+// Intern table mapping location names to dense 32-bit ids.
+// Rides store only the ids, so location equality and grouping are integer compares.
+// Names live in fixed-size chunks that never move, which keeps name() lock-free;
+// only interning a new name takes the lock.
+class LocationTable {
+private:
+    static const std::size_t CHUNK_BITS = 12;
+    static const std::size_t CHUNK_SIZE = std::size_t(1) << CHUNK_BITS;
+    static const std::size_t MAX_CHUNKS = 4096; // Up to 16M distinct locations
+
+    std::unordered_map<std::string, LocationID> ids;
+    std::string* chunks[MAX_CHUNKS];
+    std::atomic<std::uint32_t> count;
+    static const std::string UNKNOWN_NAME;
+    mutable std::mutex internLock;
+
+    LocationTable(const LocationTable&);            // Non-copyable
+    LocationTable& operator=(const LocationTable&);
+
+public:
+    // Constructor
+    LocationTable();
+
+    // Destructor
+    ~LocationTable();
+
+    // Process-wide table used by Ride; Ride resolves every id through this table
+    static LocationTable& global();
+
+    // Return the id for a name, adding it on first use (INVALID_LOCATION when full)
+    LocationID intern(const std::string& name);
+
+    // Look up an existing name without adding it
+    bool find(const std::string& name, LocationID& id) const;
+
+    // Name for an id returned by intern(); the reference stays valid for the table's lifetime.
+    // Ids this table never issued (including INVALID_LOCATION) read as "Unknown location".
+    const std::string& name(LocationID id) const {
+        if (id >= count.load(std::memory_order_acquire)) {
+            return UNKNOWN_NAME;
+        }
+        return chunks[id >> CHUNK_BITS][id & (CHUNK_SIZE - 1)];
+    }
+
+    std::size_t size() const { return count.load(std::memory_order_acquire); }
+};
+
+#endif // LOCATIONTABLE_H
@@ -0,0 +1,35 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file (mmap on POSIX, MapViewOfFile on Windows)
+class MappedFile {
+private:
+    const char* data;
+    std::size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+
+    MappedFile(const MappedFile&);            // Non-copyable
+    MappedFile& operator=(const MappedFile&);
+
+public:
+    // Constructor
+    MappedFile();
+
+    // Destructor unmaps the file
+    ~MappedFile();
+
+    // Returns false if the file cannot be opened; an empty file maps to size() == 0
+    bool open(const std::string& path);
+    void close();
+
+    const char* begin() const { return data; }
+    std::size_t size() const { return length; }
+};
+
+#endif // MAPPEDFILE_H
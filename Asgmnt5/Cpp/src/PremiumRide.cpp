@@ -1,25 +1,34 @@
 #include "PremiumRide.h"
+#include "FarePolicy.h"
 
-// Define the static constants
-const double PremiumRide::PREMIUM_RATE_PER_MILE = 2.5;
-const double PremiumRide::LUXURY_SURCHARGE = 5.0;
+// Define the static constants (the rates themselves live in FarePolicy)
+const double PremiumRide::PREMIUM_RATE_PER_MILE = FarePolicy<RideType::Premium>::ratePerMile();
+const double PremiumRide::LUXURY_SURCHARGE = FarePolicy<RideType::Premium>::surcharge();
 
 PremiumRide::PremiumRide(int id, const std::string& pickup, const std::string& dropoff, double dist)
     : Ride(id, pickup, dropoff, dist) {
 }
 
+PremiumRide::PremiumRide(int id, LocationID pickup, LocationID dropoff, double dist)
+    : Ride(id, pickup, dropoff, dist) {
+}
+
 double PremiumRide::fare() const {
-    return baseFare + (distance * PREMIUM_RATE_PER_MILE) + LUXURY_SURCHARGE;
+    // Surge applies to the metered fare; the luxury surcharge is flat
+    return (baseFare + (distance * PREMIUM_RATE_PER_MILE)) * surgeMultiplier + LUXURY_SURCHARGE;
 }
 
-void PremiumRide::rideDetails() const {
-    std::cout << "=== Premium Ride Details ===" << std::endl;
-    std::cout << "Ride ID: " << rideID << std::endl;
-    std::cout << "Pickup: " << pickupLocation << std::endl;
-    std::cout << "Dropoff: " << dropoffLocation << std::endl;
-    std::cout << "Distance: " << distance << " miles" << std::endl;
-    std::cout << "Premium Rate: $" << PREMIUM_RATE_PER_MILE << " per mile" << std::endl;
-    std::cout << "Luxury Surcharge: $" << LUXURY_SURCHARGE << std::endl;
-    std::cout << "Fare: $" << fare() << std::endl;
-    std::cout << "============================" << std::endl;
+void PremiumRide::rideDetails(std::ostream& out) const {
+    out << "=== Premium Ride Details ===\n";
+    out << "Ride ID: " << rideID << '\n';
+    out << "Pickup: " << getPickupLocation() << '\n';
+    out << "Dropoff: " << getDropoffLocation() << '\n';
+    out << "Distance: " << distance << " miles\n";
+    out << "Premium Rate: $" << PREMIUM_RATE_PER_MILE << " per mile\n";
+    out << "Luxury Surcharge: $" << LUXURY_SURCHARGE << '\n';
+    if (surgeMultiplier != 1.0) {
+        out << "Surge: x" << surgeMultiplier << '\n';
+    }
+    out << "Fare: $" << fare() << '\n';
+    out << "============================\n";
 }
\ No newline at end of file
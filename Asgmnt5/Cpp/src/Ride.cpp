@@ -1,15 +1,41 @@
 #include "Ride.h"
 
 Ride::Ride(int id, const std::string& pickup, const std::string& dropoff, double dist)
-    : rideID(id), pickupLocation(pickup), dropoffLocation(dropoff), distance(dist), baseFare(2.0) {
+    : rideID(id), pickupLocation(LocationTable::global().intern(pickup)),
+      dropoffLocation(LocationTable::global().intern(dropoff)), distance(dist), baseFare(RIDE_BASE_FARE), requestTime(0),
+      surgeMultiplier(1.0), fareRecorded(false), driverIndex(0), riderIndex(0) {
 }
 
-void Ride::rideDetails() const {
-    std::cout << "=== Ride Details ===" << std::endl;
-    std::cout << "Ride ID: " << rideID << std::endl;
-    std::cout << "Pickup: " << pickupLocation << std::endl;
-    std::cout << "Dropoff: " << dropoffLocation << std::endl;
-    std::cout << "Distance: " << distance << " miles" << std::endl;
-    std::cout << "Fare: $" << fare() << std::endl;
-    std::cout << "===================" << std::endl;
+Ride::Ride(int id, LocationID pickup, LocationID dropoff, double dist)
+    : rideID(id), pickupLocation(pickup), dropoffLocation(dropoff), distance(dist), baseFare(RIDE_BASE_FARE), requestTime(0),
+      surgeMultiplier(1.0), fareRecorded(false), driverIndex(0), riderIndex(0) {
+}
+
+void Ride::setDistance(double dist) {
+    if (fareRecorded) {
+        std::cout << "Ride " << rideID << " is already recorded; distance must be set before assignment" << std::endl;
+        return;
+    }
+    distance = dist;
+}
+
+void Ride::setSurgeMultiplier(double multiplier) {
+    if (fareRecorded) {
+        std::cout << "Ride " << rideID << " is already recorded; surge must be set before assignment" << std::endl;
+        return;
+    }
+    surgeMultiplier = multiplier;
+}
+
+void Ride::rideDetails(std::ostream& out) const {
+    out << "=== Ride Details ===\n";
+    out << "Ride ID: " << rideID << '\n';
+    out << "Pickup: " << getPickupLocation() << '\n';
+    out << "Dropoff: " << getDropoffLocation() << '\n';
+    out << "Distance: " << distance << " miles\n";
+    if (surgeMultiplier != 1.0) {
+        out << "Surge: x" << surgeMultiplier << '\n';
+    }
+    out << "Fare: $" << fare() << '\n';
+    out << "===================\n";
 }
\ No newline at end of file
@@ -1,20 +1,41 @@
 #ifndef RIDE_H
 #define RIDE_H
 
+#include <cstdint>
 #include <string>
 #include <iostream>
+#include <ctime>
+#include "LocationTable.h"
+
+// Closed set of ride categories, used for filtering and per-type aggregates
+enum class RideType {
+    Standard,
+    Premium
+};
+const int RIDE_TYPE_COUNT = 2;
+
+// Flat fee charged on every ride, shared by the class hierarchy and FarePolicy
+constexpr double RIDE_BASE_FARE = 2.0;
 
 class Ride {
 protected:
     int rideID;
-    std::string pickupLocation;
-    std::string dropoffLocation;
+    LocationID pickupLocation;  // Interned in LocationTable::global()
+    LocationID dropoffLocation;
     double distance;
     double baseFare;
+    std::time_t requestTime; // 0 when unknown
+    double surgeMultiplier;  // Demand pricing applied at request time, 1.0 = none
+    bool fareRecorded;       // A Driver or Rider has aggregated fare(); the surge is fixed from then on
+    std::uint32_t driverIndex; // Position in the assigned driver's history, kept by Driver
+    std::uint32_t riderIndex;  // Position in the requesting rider's history, kept by Rider
 
 public:
     // Constructor
     Ride(int id, const std::string& pickup, const std::string& dropoff, double dist);
+    // The ids must come from LocationTable::global(); ids of any other table would
+    // resolve to the wrong names
+    Ride(int id, LocationID pickup, LocationID dropoff, double dist);
     
     // Virtual destructor for proper cleanup in inheritance
     virtual ~Ride() = default;
@@ -23,17 +44,35 @@ public:
     virtual double fare() const = 0;
     
     // Virtual method that can be overridden
-    virtual void rideDetails() const;
+    virtual void rideDetails(std::ostream& out = std::cout) const;
+    
+    // Category of the concrete ride class
+    virtual RideType getRideType() const = 0;
     
     // Getter methods (encapsulation)
     int getRideID() const { return rideID; }
-    std::string getPickupLocation() const { return pickupLocation; }
-    std::string getDropoffLocation() const { return dropoffLocation; }
+    const std::string& getPickupLocation() const { return LocationTable::global().name(pickupLocation); }
+    const std::string& getDropoffLocation() const { return LocationTable::global().name(dropoffLocation); }
+    LocationID getPickupID() const { return pickupLocation; }
+    LocationID getDropoffID() const { return dropoffLocation; }
     double getDistance() const { return distance; }
     double getBaseFare() const { return baseFare; }
+    std::time_t getRequestTime() const { return requestTime; }
+    double getSurgeMultiplier() const { return surgeMultiplier; }
+    bool isFareRecorded() const { return fareRecorded; }
     
     // Setter methods
-    void setDistance(double dist) { distance = dist; }
+    void setRequestTime(std::time_t when) { requestTime = when; }
+    // Only before the ride is recorded, so earnings and spending aggregates match fare()
+    void setDistance(double dist);
+    void setSurgeMultiplier(double multiplier);
+    void markFareRecorded() { fareRecorded = true; }
+    
+    // History positions, so Driver and Rider remove a ride in O(1)
+    std::uint32_t getDriverIndex() const { return driverIndex; }
+    std::uint32_t getRiderIndex() const { return riderIndex; }
+    void setDriverIndex(std::uint32_t index) { driverIndex = index; }
+    void setRiderIndex(std::uint32_t index) { riderIndex = index; }
 };
 
 #endif // RIDE_H
\ No newline at end of file
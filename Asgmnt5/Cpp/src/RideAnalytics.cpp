@@ -0,0 +1,323 @@
+#include "RideAnalytics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+const std::uint64_t EMPTY_KEY = ~std::uint64_t(0);
+const std::size_t CHUNK_RECORDS = 64 * 1024;
+const int PARTITION_BITS = 6;
+const std::size_t PARTITION_COUNT = std::size_t(1) << PARTITION_BITS;
+
+std::uint64_t mixKey(std::uint64_t key) {
+    // splitmix64 finalizer: route keys are highly structured
+    key = (key ^ (key >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    key = (key ^ (key >> 27)) * 0x94D049BB133111EBULL;
+    return key ^ (key >> 31);
+}
+
+// Group accumulator; fares use Neumaier summation like FareStats
+struct Accumulator {
+    std::uint64_t count;
+    double fareSum;
+    double fareCompensation;
+    double distanceSum;
+    DistanceSketch distances;
+
+    Accumulator() : count(0), fareSum(0.0), fareCompensation(0.0), distanceSum(0.0) {}
+
+    void addFare(double value) {
+        double t = fareSum + value;
+        if (std::fabs(fareSum) >= std::fabs(value)) {
+            fareCompensation += (fareSum - t) + value;
+        } else {
+            fareCompensation += (value - t) + fareSum;
+        }
+        fareSum = t;
+    }
+
+    void merge(const Accumulator& other) {
+        count += other.count;
+        addFare(other.fareSum);
+        addFare(other.fareCompensation);
+        distanceSum += other.distanceSum;
+        distances.merge(other.distances);
+    }
+};
+
+// Linear-probing hash table. Keys are kept apart from the accumulators so probing
+// scans a dense array of 8-byte keys. EMPTY_KEY marks free slots but is also a legal key
+// (e.g. TimeBucket -1, or a route between two NO_ID locations), so that one group is
+// kept outside the array.
+class GroupTable {
+private:
+    std::vector<std::uint64_t> keys;
+    std::vector<Accumulator> values;
+    std::size_t used;
+    std::size_t mask;
+    bool hasEmptyKeyGroup;
+    Accumulator emptyKeyGroup;
+
+    void grow() {
+        std::vector<std::uint64_t> oldKeys;
+        std::vector<Accumulator> oldValues;
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+
+        std::size_t capacity = oldKeys.empty() ? 64 : oldKeys.size() * 2;
+        keys.assign(capacity, EMPTY_KEY);
+        values.assign(capacity, Accumulator());
+        mask = capacity - 1;
+        used = 0;
+        for (std::size_t i = 0; i < oldKeys.size(); ++i) {
+            if (oldKeys[i] != EMPTY_KEY) {
+                slotFor(oldKeys[i], mixKey(oldKeys[i])) = oldValues[i];
+            }
+        }
+    }
+
+public:
+    GroupTable() : used(0), mask(0), hasEmptyKeyGroup(false) {}
+
+    Accumulator& slotFor(std::uint64_t key, std::uint64_t hash) {
+        if (key == EMPTY_KEY) {
+            hasEmptyKeyGroup = true;
+            return emptyKeyGroup;
+        }
+        if ((used + 1) * 4 > keys.size() * 3) { // Keep the load factor under 3/4
+            grow();
+        }
+        std::size_t slot = hash & mask;
+        while (keys[slot] != key) {
+            if (keys[slot] == EMPTY_KEY) {
+                keys[slot] = key;
+                ++used;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        return values[slot];
+    }
+
+    void mergeInto(GroupTable& target) const {
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] != EMPTY_KEY) {
+                target.slotFor(keys[i], mixKey(keys[i])).merge(values[i]);
+            }
+        }
+        if (hasEmptyKeyGroup) {
+            target.slotFor(EMPTY_KEY, mixKey(EMPTY_KEY)).merge(emptyKeyGroup);
+        }
+    }
+
+    void appendTo(std::vector<GroupStats>& out) const {
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] != EMPTY_KEY) {
+                appendGroup(keys[i], values[i], out);
+            }
+        }
+        if (hasEmptyKeyGroup) {
+            appendGroup(EMPTY_KEY, emptyKeyGroup, out);
+        }
+    }
+
+    static void appendGroup(std::uint64_t key, const Accumulator& value, std::vector<GroupStats>& out) {
+        GroupStats group;
+        group.key = key;
+        group.count = value.count;
+        group.totalFare = value.fareSum + value.fareCompensation;
+        group.totalDistance = value.distanceSum;
+        group.distances = value.distances;
+        out.push_back(group);
+    }
+
+    std::size_t size() const { return used + (hasEmptyKeyGroup ? 1 : 0); }
+};
+
+std::uint64_t groupKey(const TripRecord& record, const RideAnalytics::Query& query) {
+    switch (query.groupBy) {
+    case RideAnalytics::GroupBy::Route:
+        return (static_cast<std::uint64_t>(record.pickup) << 32) | record.dropoff;
+    case RideAnalytics::GroupBy::RideType:
+        return record.type;
+    case RideAnalytics::GroupBy::Driver:
+        return static_cast<std::uint32_t>(record.driverID);
+    case RideAnalytics::GroupBy::TimeBucket:
+        return static_cast<std::uint64_t>(record.requestTime / query.bucketSeconds);
+    }
+    return 0;
+}
+
+struct Chunk {
+    const TripRecord* records;
+    std::size_t count;
+};
+
+} // namespace
+
+DistanceSketch::DistanceSketch() {
+    std::fill(bins, bins + BIN_COUNT, 0u);
+}
+
+int DistanceSketch::binFor(double distance) {
+    if (!(distance > 0.125)) {
+        return 0;
+    }
+    int bin = static_cast<int>(4.0 * std::log2(distance * 8.0));
+    return bin < BIN_COUNT ? bin : BIN_COUNT - 1;
+}
+
+void DistanceSketch::merge(const DistanceSketch& other) {
+    for (int i = 0; i < BIN_COUNT; ++i) {
+        bins[i] += other.bins[i];
+    }
+}
+
+double DistanceSketch::quantile(double q) const {
+    std::uint64_t total = 0;
+    for (int i = 0; i < BIN_COUNT; ++i) {
+        total += bins[i];
+    }
+    if (total == 0) {
+        return 0.0;
+    }
+
+    std::uint64_t target = static_cast<std::uint64_t>(std::max(0.0, std::min(1.0, q)) * (total - 1));
+    std::uint64_t seen = 0;
+    int bin = 0;
+    for (; bin < BIN_COUNT - 1; ++bin) {
+        seen += bins[bin];
+        if (seen > target) {
+            break;
+        }
+    }
+    // Geometric midpoint of the bin
+    return 0.125 * std::exp2((bin + 0.5) / 4.0);
+}
+
+std::vector<GroupStats> RideAnalytics::aggregate(const std::vector<Span>& spans, const Query& query) {
+    std::vector<Chunk> chunks;
+    for (std::size_t s = 0; s < spans.size(); ++s) {
+        for (std::size_t offset = 0; offset < spans[s].count; offset += CHUNK_RECORDS) {
+            Chunk chunk;
+            chunk.records = spans[s].records + offset;
+            chunk.count = std::min(CHUNK_RECORDS, spans[s].count - offset);
+            chunks.push_back(chunk);
+        }
+    }
+
+    Query effective = query;
+    if (effective.bucketSeconds <= 0) {
+        effective.bucketSeconds = 3600;
+    }
+    unsigned threads = query.threads ? query.threads : std::thread::hardware_concurrency();
+    threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(chunks.size())));
+
+    // Phase 1: every worker aggregates whole chunks into its own partitioned tables
+    std::vector<std::vector<GroupTable> > local(threads, std::vector<GroupTable>(PARTITION_COUNT));
+    std::atomic<std::size_t> nextChunk(0);
+    auto scan = [&](unsigned worker) {
+        std::vector<GroupTable>& tables = local[worker];
+        for (;;) {
+            std::size_t c = nextChunk.fetch_add(1, std::memory_order_relaxed);
+            if (c >= chunks.size()) {
+                return;
+            }
+            const TripRecord* records = chunks[c].records;
+            for (std::size_t i = 0; i < chunks[c].count; ++i) {
+                std::uint64_t key = groupKey(records[i], effective);
+                std::uint64_t hash = mixKey(key);
+                Accumulator& group = tables[hash >> (64 - PARTITION_BITS)].slotFor(key, hash);
+                ++group.count;
+                group.addFare(records[i].fare);
+                group.distanceSum += records[i].distance;
+                group.distances.add(records[i].distance);
+            }
+        }
+    };
+
+    // Phase 2: each partition is merged by exactly one worker, so no locking is needed
+    std::vector<GroupTable> merged(PARTITION_COUNT);
+    std::atomic<std::size_t> nextPartition(0);
+    auto mergePartitions = [&]() {
+        for (;;) {
+            std::size_t p = nextPartition.fetch_add(1, std::memory_order_relaxed);
+            if (p >= PARTITION_COUNT) {
+                return;
+            }
+            for (unsigned t = 0; t < threads; ++t) {
+                local[t][p].mergeInto(merged[p]);
+                local[t][p] = GroupTable(); // Release memory as we go
+            }
+        }
+    };
+
+    if (threads == 1) {
+        scan(0);
+        mergePartitions();
+    } else {
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.push_back(std::thread(scan, t));
+        }
+        for (unsigned t = 0; t < threads; ++t) {
+            workers[t].join();
+        }
+        workers.clear();
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.push_back(std::thread(mergePartitions));
+        }
+        for (unsigned t = 0; t < threads; ++t) {
+            workers[t].join();
+        }
+    }
+
+    std::size_t groupCount = 0;
+    for (std::size_t p = 0; p < PARTITION_COUNT; ++p) {
+        groupCount += merged[p].size();
+    }
+    std::vector<GroupStats> groups;
+    groups.reserve(groupCount);
+    for (std::size_t p = 0; p < PARTITION_COUNT; ++p) {
+        merged[p].appendTo(groups);
+    }
+    return groups;
+}
+
+std::vector<GroupStats> RideAnalytics::aggregate(const std::vector<TripRecord>& records, const Query& query) {
+    std::vector<Span> spans;
+    if (!records.empty()) {
+        Span span;
+        span.records = records.data();
+        span.count = records.size();
+        spans.push_back(span);
+    }
+    return aggregate(spans, query);
+}
+
+std::vector<GroupStats> RideAnalytics::aggregate(const RideJournalReader& journal, const Query& query) {
+    std::vector<Span> spans;
+    for (std::size_t s = 0; s < journal.getSegmentCount(); ++s) {
+        Span span;
+        span.records = journal.getRecords(s, span.count);
+        if (span.records != nullptr && span.count > 0) {
+            spans.push_back(span);
+        }
+    }
+    return aggregate(spans, query);
+}
+
+void RideAnalytics::sortByRevenue(std::vector<GroupStats>& groups) {
+    std::sort(groups.begin(), groups.end(), [](const GroupStats& a, const GroupStats& b) {
+        return a.totalFare > b.totalFare || (a.totalFare == b.totalFare && a.key < b.key);
+    });
+}
+
+void RideAnalytics::collectTrips(const Driver& driver, std::vector<TripRecord>& out) {
+    int driverID = driver.getDriverID();
+    driver.forEachAssignedRide([&](const Ride& ride) {
+        out.push_back(makeTripRecord(ride, driverID, 0));
+    });
+}
@@ -0,0 +1,90 @@
+#ifndef RIDEANALYTICS_H
+#define RIDEANALYTICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "TripRecord.h"
+#include "RideJournal.h"
+#include "Driver.h"
+
+// Fixed-size log-scale histogram of trip distances for approximate percentiles.
+// Bins grow by 2^(1/4) from 1/8 mile, so a quantile is within about 9% of the true
+// distance; the first and last bins also hold shorter and longer trips.
+class DistanceSketch {
+public:
+    static const int BIN_COUNT = 40;
+
+private:
+    std::uint32_t bins[BIN_COUNT];
+
+    static int binFor(double distance);
+
+public:
+    // Constructor
+    DistanceSketch();
+
+    void add(double distance) { ++bins[binFor(distance)]; }
+    void merge(const DistanceSketch& other);
+
+    // Approximate distance at quantile q in [0, 1]; 0 when empty
+    double quantile(double q) const;
+};
+
+// Aggregates of one group
+struct GroupStats {
+    std::uint64_t key;          // See RideAnalytics::GroupBy
+    std::uint64_t count;
+    double totalFare;
+    double totalDistance;
+    DistanceSketch distances;
+
+    double meanFare() const { return count ? totalFare / count : 0.0; }
+    double meanDistance() const { return count ? totalDistance / count : 0.0; }
+};
+
+// Group-by aggregation (count, fare and distance totals, distance percentiles) over trip
+// records, e.g. a memory-mapped RideJournal or trips collected from drivers.
+// Records are handed out to worker threads in chunks. Each worker aggregates into its own
+// open-addressing hash tables, one per partition of the key space, so the hot loop shares
+// nothing. Partitions are then merged in parallel, each by a single thread.
+class RideAnalytics {
+public:
+    enum class GroupBy {
+        Route,          // key = pickup << 32 | dropoff (ids as stored in the records)
+        RideType,       // key = RideType
+        Driver,         // key = driver id
+        TimeBucket      // key = requestTime / bucketSeconds
+    };
+
+    struct Query {
+        GroupBy groupBy;
+        std::int64_t bucketSeconds; // TimeBucket width
+        unsigned threads;           // 0 = one per hardware thread
+
+        explicit Query(GroupBy by = GroupBy::Route) : groupBy(by), bucketSeconds(3600), threads(0) {}
+    };
+
+    // Contiguous run of records, e.g. one journal segment
+    struct Span {
+        const TripRecord* records;
+        std::size_t count;
+    };
+
+    // Aggregate; groups come back in no particular order
+    static std::vector<GroupStats> aggregate(const std::vector<Span>& spans, const Query& query);
+    static std::vector<GroupStats> aggregate(const std::vector<TripRecord>& records, const Query& query);
+    static std::vector<GroupStats> aggregate(const RideJournalReader& journal, const Query& query);
+
+    // Highest total fare first
+    static void sortByRevenue(std::vector<GroupStats>& groups);
+
+    // Append a driver's ride history as records (rider ids are not known to Driver and are 0)
+    static void collectTrips(const Driver& driver, std::vector<TripRecord>& out);
+
+    // Route key parts
+    static std::uint32_t routePickup(std::uint64_t key) { return static_cast<std::uint32_t>(key >> 32); }
+    static std::uint32_t routeDropoff(std::uint64_t key) { return static_cast<std::uint32_t>(key); }
+};
+
+#endif // RIDEANALYTICS_H
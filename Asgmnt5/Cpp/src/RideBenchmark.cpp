@@ -0,0 +1,397 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Ride.h"
+#include "StandardRide.h"
+#include "PremiumRide.h"
+#include "Driver.h"
+#include "RidePool.h"
+#include "FarePolicy.h"
+#include "LocationTable.h"
+#include "RideReport.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Micro-benchmarks for the ride-sharing subsystem.
+// Usage: ride_benchmark [maxRides] [jsonPath]
+// Runs every scenario for 1k, 10k, ... rides up to maxRides (default 1M, at most 10M)
+// with several premium ride ratios and writes the results as JSON.
+
+// ---------------------------------------------------------------------------
+// Allocation counting: every operator new in the process goes through here
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete" // The replacements below pair malloc/free
+#endif
+
+static std::atomic<std::uint64_t> allocationCount(0);
+static std::atomic<std::uint64_t> allocationBytes(0);
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add(size, std::memory_order_relaxed);
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// ---------------------------------------------------------------------------
+// Hardware cache-miss counter (Linux perf events); reports -1 when unavailable
+
+class CacheMissCounter {
+private:
+    int fd;
+
+public:
+    CacheMissCounter() : fd(-1) {
+#ifdef __linux__
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0) {
+            close(fd);
+        }
+#endif
+    }
+
+    void start() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    long long stop() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            long long count = 0;
+            if (read(fd, &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count))) {
+                return count;
+            }
+        }
+#endif
+        return -1;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Measurement
+
+struct Measurement {
+    std::string name;
+    std::size_t rides;
+    double premiumShare;
+    std::size_t operations;
+    double seconds;
+    double p50Ns;
+    double p90Ns;
+    double p99Ns;
+    double allocationsPerOp;
+    double bytesPerOp;
+    double cacheMissesPerOp; // -1 when perf counters are unavailable
+};
+
+static CacheMissCounter cacheMisses;
+static volatile double sink; // Keeps results observable so loops are not optimized away
+
+static double percentile(std::vector<double>& values, double fraction) {
+    std::size_t index = static_cast<std::size_t>(fraction * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// Runs body(begin, end) over [0, operations) in batches and times every batch.
+// Latency percentiles are per operation, at batch granularity.
+template <typename Body>
+Measurement measure(const std::string& name, std::size_t rides, double premiumShare,
+                    std::size_t operations, std::size_t batchSize, Body body) {
+    std::vector<double> batchNs;
+    batchNs.reserve(operations / batchSize + 1);
+
+    std::uint64_t allocationsBefore = allocationCount.load();
+    std::uint64_t bytesBefore = allocationBytes.load();
+    cacheMisses.start();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (std::size_t begin = 0; begin < operations; begin += batchSize) {
+        std::size_t end = std::min(begin + batchSize, operations);
+        std::chrono::steady_clock::time_point batchStart = std::chrono::steady_clock::now();
+        body(begin, end);
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - batchStart;
+        batchNs.push_back(elapsed.count() / (end - begin));
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    long long misses = cacheMisses.stop();
+    std::uint64_t allocations = allocationCount.load() - allocationsBefore;
+    std::uint64_t bytes = allocationBytes.load() - bytesBefore;
+
+    Measurement result;
+    result.name = name;
+    result.rides = rides;
+    result.premiumShare = premiumShare;
+    result.operations = operations;
+    result.seconds = seconds;
+    result.p50Ns = percentile(batchNs, 0.50);
+    result.p90Ns = percentile(batchNs, 0.90);
+    result.p99Ns = percentile(batchNs, 0.99);
+    result.allocationsPerOp = static_cast<double>(allocations) / operations;
+    result.bytesPerOp = static_cast<double>(bytes) / operations;
+    result.cacheMissesPerOp = misses < 0 ? -1.0 : static_cast<double>(misses) / operations;
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Fixtures
+
+struct RideSpec {
+    int id;
+    bool premium;
+    LocationID pickup;
+    LocationID dropoff;
+    double distance;
+};
+
+static std::vector<RideSpec> makeSpecs(std::size_t count, double premiumShare, std::uint64_t seed) {
+    static std::vector<LocationID> locations;
+    if (locations.empty()) {
+        for (int i = 0; i < 1000; ++i) {
+            std::ostringstream name;
+            name << "Location " << i;
+            locations.push_back(LocationTable::global().intern(name.str()));
+        }
+    }
+
+    std::vector<RideSpec> specs(count);
+    std::uint64_t state = seed;
+    for (std::size_t i = 0; i < count; ++i) {
+        // splitmix64
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        z ^= z >> 31;
+        specs[i].id = static_cast<int>(i) + 1;
+        specs[i].premium = (z & 0xFFFF) < premiumShare * 65536.0;
+        specs[i].pickup = locations[(z >> 16) % locations.size()];
+        specs[i].dropoff = locations[(z >> 32) % locations.size()];
+        specs[i].distance = 0.5 + ((z >> 48) & 0xFF) / 10.0;
+    }
+    return specs;
+}
+
+static std::shared_ptr<Ride> makeSharedRide(const RideSpec& spec) {
+    if (spec.premium) {
+        return std::make_shared<PremiumRide>(spec.id, spec.pickup, spec.dropoff, spec.distance);
+    }
+    return std::make_shared<StandardRide>(spec.id, spec.pickup, spec.dropoff, spec.distance);
+}
+
+// Discards everything written to it
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// ---------------------------------------------------------------------------
+// Scenarios
+
+static void runScenarios(std::size_t rides, double premiumShare, std::vector<Measurement>& results) {
+    std::vector<RideSpec> specs = makeSpecs(rides, premiumShare, 12345);
+    const std::size_t BATCH = 1000;
+    // Whole-history operations are repeated enough to be measurable at every size
+    std::size_t repeats = std::max<std::size_t>(3, std::min<std::size_t>(1000, 10000000 / rides));
+
+    std::vector<std::shared_ptr<Ride>> shared;
+    shared.reserve(rides);
+    results.push_back(measure("construct/make_shared", rides, premiumShare, rides, BATCH,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                shared.push_back(makeSharedRide(specs[i]));
+            }
+        }));
+
+    {
+        RidePool pool;
+        std::vector<Ride*> pooled;
+        pooled.reserve(rides);
+        results.push_back(measure("construct/pool", rides, premiumShare, rides, BATCH,
+            [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    const RideSpec& spec = specs[i];
+                    if (spec.premium) {
+                        pooled.push_back(pool.create<PremiumRide>(spec.id, spec.pickup, spec.dropoff, spec.distance));
+                    } else {
+                        pooled.push_back(pool.create<StandardRide>(spec.id, spec.pickup, spec.dropoff, spec.distance));
+                    }
+                }
+            }));
+    }
+
+    results.push_back(measure("fare/virtual", rides, premiumShare, rides, BATCH,
+        [&](std::size_t begin, std::size_t end) {
+            double total = 0.0;
+            for (std::size_t i = begin; i < end; ++i) {
+                total += shared[i]->fare();
+            }
+            sink = total;
+        }));
+
+    {
+        std::vector<RideRecord> records(rides);
+        for (std::size_t i = 0; i < rides; ++i) {
+            records[i] = makeRideRecord(*shared[i]);
+        }
+        std::vector<double> fares(rides);
+        results.push_back(measure("fare/static", rides, premiumShare, rides, BATCH,
+            [&](std::size_t begin, std::size_t end) {
+                computeFares(&records[begin], end - begin, &fares[begin]);
+                sink = fares[begin];
+            }));
+    }
+
+    Driver driver(1, "Benchmark Driver");
+    for (std::size_t i = 0; i < rides; ++i) {
+        driver.recordRide(shared[i]);
+    }
+
+    results.push_back(measure("earnings/resum", rides, premiumShare, repeats, 1,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t r = begin; r < end; ++r) {
+                double total = 0.0;
+                driver.forEachAssignedRide([&](const Ride& ride) { total += ride.fare(); });
+                sink = total;
+            }
+        }));
+
+    results.push_back(measure("earnings/incremental", rides, premiumShare, 1000000, BATCH,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t r = begin; r < end; ++r) {
+                sink = driver.calculateTotalEarnings();
+            }
+        }));
+
+    results.push_back(measure("history/copy", rides, premiumShare, repeats, 1,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t r = begin; r < end; ++r) {
+                std::vector<std::shared_ptr<Ride>> copy = driver.getAssignedRides();
+                sink = copy.back()->getDistance();
+            }
+        }));
+
+    results.push_back(measure("history/view", rides, premiumShare, repeats, 1,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t r = begin; r < end; ++r) {
+                RideRange view = driver.viewAssignedRides();
+                sink = view[view.size() - 1].getDistance();
+            }
+        }));
+
+    // Console formatting is slow, so it only runs on a bounded prefix
+    NullBuffer nullBuffer;
+    std::streambuf* original = std::cout.rdbuf(&nullBuffer);
+    std::size_t detailed = std::min<std::size_t>(rides, 100000);
+    results.push_back(measure("output/rideDetails", rides, premiumShare, detailed, BATCH,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                shared[i]->rideDetails();
+            }
+        }));
+    std::ostream nullStream(&nullBuffer);
+    results.push_back(measure("output/csvReport", rides, premiumShare, detailed, BATCH,
+        [&](std::size_t begin, std::size_t end) {
+            RideReportWriter report(nullStream, ReportFormat::Csv);
+            for (std::size_t i = begin; i < end; ++i) {
+                report.write(*shared[i]);
+            }
+            report.end();
+        }));
+    std::cout.rdbuf(original);
+}
+
+static void writeJson(const std::vector<Measurement>& results, const std::string& path) {
+    std::ofstream out(path.c_str());
+    out << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Measurement& m = results[i];
+        out << "    {\"name\": \"" << m.name << "\", \"rides\": " << m.rides
+            << ", \"premiumShare\": " << m.premiumShare << ", \"operations\": " << m.operations
+            << ", \"seconds\": " << m.seconds << ", \"opsPerSecond\": " << (m.operations / m.seconds)
+            << ", \"p50Ns\": " << m.p50Ns << ", \"p90Ns\": " << m.p90Ns << ", \"p99Ns\": " << m.p99Ns
+            << ", \"allocationsPerOp\": " << m.allocationsPerOp << ", \"bytesPerOp\": " << m.bytesPerOp
+            << ", \"cacheMissesPerOp\": " << m.cacheMissesPerOp << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t maxRides = argc > 1 ? static_cast<std::size_t>(std::atof(argv[1])) : 1000000;
+    std::string jsonPath = argc > 2 ? argv[2] : "benchmark_results.json";
+    if (maxRides < 1000 || maxRides > 10000000) {
+        std::cout << "maxRides must be between 1000 and 10000000" << std::endl;
+        return 1;
+    }
+
+    const double premiumShares[] = { 0.0, 0.2, 0.5 };
+    std::vector<Measurement> results;
+
+    std::printf("%-22s %10s %7s %14s %10s %10s %10s %9s %9s\n", "benchmark", "rides", "premium",
+                "ops/s", "p50 ns", "p90 ns", "p99 ns", "allocs/op", "miss/op");
+    for (std::size_t rides = 1000; rides <= maxRides; rides *= 10) {
+        for (std::size_t s = 0; s < sizeof(premiumShares) / sizeof(premiumShares[0]); ++s) {
+            std::size_t first = results.size();
+            runScenarios(rides, premiumShares[s], results);
+            for (std::size_t i = first; i < results.size(); ++i) {
+                const Measurement& m = results[i];
+                std::printf("%-22s %10zu %7.2f %14.0f %10.1f %10.1f %10.1f %9.2f %9.2f\n", m.name.c_str(), m.rides,
+                            m.premiumShare, m.operations / m.seconds, m.p50Ns, m.p90Ns, m.p99Ns,
+                            m.allocationsPerOp, m.cacheMissesPerOp);
+            }
+        }
+    }
+
+    writeJson(results, jsonPath);
+    std::cout << "Results written to " << jsonPath << std::endl;
+    return 0;
+}
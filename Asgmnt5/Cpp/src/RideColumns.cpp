@@ -0,0 +1,338 @@
+#include "RideColumns.h"
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+const char COLUMN_MAGIC[8] = { 'R', 'I', 'D', 'E', 'C', 'O', 'L', '1' };
+const std::uint32_t COLUMN_VERSION = 1;
+
+struct StandardColumn {
+    const char* name;
+    ColumnType type;
+    std::uint32_t width;
+};
+
+// Indexed by RideColumn
+const StandardColumn STANDARD_COLUMNS[] = {
+    { "ride_id", ColumnType::Int32, 4 },
+    { "type", ColumnType::UInt8, 1 },
+    { "pickup", ColumnType::Dictionary, 4 },
+    { "dropoff", ColumnType::Dictionary, 4 },
+    { "distance", ColumnType::Float64, 8 },
+    { "fare", ColumnType::Float64, 8 }
+};
+
+const int STANDARD_COLUMN_COUNT = static_cast<int>(RideColumn::Count);
+
+std::uint64_t alignUp(std::uint64_t value) {
+    return (value + 7) & ~std::uint64_t(7);
+}
+
+} // namespace
+
+const std::uint32_t RideColumnWriter::NO_ID;
+const std::size_t RideColumnWriter::DEFAULT_ROW_GROUP_ROWS;
+
+RideColumnWriter::RideColumnWriter(const std::string& path, std::size_t rowsPerGroup)
+    : file(nullptr), rowGroupRows(rowsPerGroup > 0 ? rowsPerGroup : 1), offset(0), rowCount(0), failed(false) {
+    file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cout << "Cannot create column file " << path << std::endl;
+        return;
+    }
+
+    ColumnFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, COLUMN_MAGIC, sizeof(COLUMN_MAGIC));
+    header.version = COLUMN_VERSION;
+    writeBytes(&header, sizeof(header));
+}
+
+RideColumnWriter::~RideColumnWriter() {
+    close();
+}
+
+std::uint32_t RideColumnWriter::fileLocation(LocationID location) {
+    if (location == INVALID_LOCATION) {
+        return NO_ID; // Out of range for the dictionary, resolves to INVALID_LOCATION
+    }
+    if (location >= fileLocationIDs.size()) {
+        fileLocationIDs.resize(location + 1, NO_ID);
+    }
+    if (fileLocationIDs[location] == NO_ID) {
+        fileLocationIDs[location] = static_cast<std::uint32_t>(dictionary.size());
+        dictionary.push_back(location);
+    }
+    return fileLocationIDs[location];
+}
+
+void RideColumnWriter::append(const Ride& ride) {
+    if (!isOpen()) {
+        return;
+    }
+    rideIDs.push_back(ride.getRideID());
+    types.push_back(static_cast<std::uint8_t>(ride.getRideType()));
+    pickups.push_back(fileLocation(ride.getPickupID()));
+    dropoffs.push_back(fileLocation(ride.getDropoffID()));
+    distances.push_back(ride.getDistance());
+    fares.push_back(ride.fare());
+    if (rideIDs.size() >= rowGroupRows) {
+        flushRowGroup();
+    }
+}
+
+bool RideColumnWriter::writeBytes(const void* bytes, std::size_t size) {
+    if (size > 0 && std::fwrite(bytes, 1, size, file) != size) {
+        failed = true;
+    }
+    offset += size;
+    return !failed;
+}
+
+bool RideColumnWriter::writeChunk(const void* bytes, std::size_t size) {
+    static const char PADDING[8] = { 0 };
+    writeBytes(bytes, size);
+    return writeBytes(PADDING, static_cast<std::size_t>(alignUp(offset) - offset));
+}
+
+bool RideColumnWriter::flushRowGroup() {
+    std::size_t rows = rideIDs.size();
+    if (rows == 0) {
+        return !failed;
+    }
+
+    // Chunks are written in RideColumn order
+    directory.push_back(rows);
+    directory.push_back(offset);
+    writeChunk(&rideIDs[0], rows * sizeof(std::int32_t));
+    directory.push_back(offset);
+    writeChunk(&types[0], rows * sizeof(std::uint8_t));
+    directory.push_back(offset);
+    writeChunk(&pickups[0], rows * sizeof(std::uint32_t));
+    directory.push_back(offset);
+    writeChunk(&dropoffs[0], rows * sizeof(std::uint32_t));
+    directory.push_back(offset);
+    writeChunk(&distances[0], rows * sizeof(double));
+    directory.push_back(offset);
+    writeChunk(&fares[0], rows * sizeof(double));
+
+    rowCount += rows;
+    rideIDs.clear();
+    types.clear();
+    pickups.clear();
+    dropoffs.clear();
+    distances.clear();
+    fares.clear();
+    return !failed;
+}
+
+bool RideColumnWriter::close() {
+    if (!isOpen()) {
+        return false;
+    }
+    flushRowGroup();
+
+    // Location dictionary: offsets, then the concatenated names
+    ColumnFileTrailer trailer;
+    std::memset(&trailer, 0, sizeof(trailer));
+    trailer.dictionaryOffset = offset;
+    LocationTable& table = LocationTable::global();
+    std::vector<std::uint32_t> nameOffsets(dictionary.size() + 1, 0);
+    for (std::size_t i = 0; i < dictionary.size(); ++i) {
+        nameOffsets[i + 1] = nameOffsets[i] + static_cast<std::uint32_t>(table.name(dictionary[i]).size());
+    }
+    writeBytes(&nameOffsets[0], nameOffsets.size() * sizeof(std::uint32_t));
+    for (std::size_t i = 0; i < dictionary.size(); ++i) {
+        const std::string& name = table.name(dictionary[i]);
+        writeBytes(name.data(), name.size());
+    }
+    writeChunk(nullptr, 0);
+
+    trailer.schemaOffset = offset;
+    for (int c = 0; c < STANDARD_COLUMN_COUNT; ++c) {
+        ColumnDescriptor descriptor;
+        std::memset(&descriptor, 0, sizeof(descriptor));
+        std::strncpy(descriptor.name, STANDARD_COLUMNS[c].name, sizeof(descriptor.name) - 1);
+        descriptor.type = static_cast<std::uint32_t>(STANDARD_COLUMNS[c].type);
+        descriptor.width = STANDARD_COLUMNS[c].width;
+        writeBytes(&descriptor, sizeof(descriptor));
+    }
+    if (!directory.empty()) {
+        writeBytes(&directory[0], directory.size() * sizeof(std::uint64_t));
+    }
+
+    trailer.rowCount = rowCount;
+    trailer.locationCount = static_cast<std::uint32_t>(dictionary.size());
+    trailer.columnCount = STANDARD_COLUMN_COUNT;
+    trailer.rowGroupCount = static_cast<std::uint32_t>(directory.size() / (STANDARD_COLUMN_COUNT + 1));
+    trailer.version = COLUMN_VERSION;
+    std::memcpy(trailer.magic, COLUMN_MAGIC, sizeof(COLUMN_MAGIC));
+    writeBytes(&trailer, sizeof(trailer));
+
+    if (std::fclose(file) != 0) {
+        failed = true;
+    }
+    file = nullptr;
+    if (failed) {
+        std::cout << "Column file write failed" << std::endl;
+    }
+    return !failed;
+}
+
+RideColumnReader::RideColumnReader(const std::string& path)
+    : trailer(nullptr), schema(nullptr), directory(nullptr), nameOffsets(nullptr), names(nullptr) {
+    for (int c = 0; c < STANDARD_COLUMN_COUNT; ++c) {
+        standardColumns[c] = -1;
+    }
+    if (!file.open(path)) {
+        std::cout << "Cannot open column file " << path << std::endl;
+        return;
+    }
+    if (!validate()) {
+        std::cout << "Invalid or incomplete column file " << path << std::endl;
+        trailer = nullptr;
+        file.close();
+    }
+}
+
+bool RideColumnReader::validate() {
+    const char* base = file.begin();
+    std::uint64_t size = file.size();
+    if (size < sizeof(ColumnFileHeader) + sizeof(ColumnFileTrailer) || size % 8 != 0
+        || std::memcmp(base, COLUMN_MAGIC, sizeof(COLUMN_MAGIC)) != 0) {
+        return false;
+    }
+
+    trailer = reinterpret_cast<const ColumnFileTrailer*>(base + size - sizeof(ColumnFileTrailer));
+    if (std::memcmp(trailer->magic, COLUMN_MAGIC, sizeof(COLUMN_MAGIC)) != 0 || trailer->version != COLUMN_VERSION) {
+        return false;
+    }
+
+    // Footer sections must lie in order between the header and the trailer. Every bound
+    // is checked subtract-first, so no corrupt offset or count can wrap the arithmetic.
+    std::uint64_t footerEnd = size - sizeof(ColumnFileTrailer);
+    std::uint64_t dictionaryBytes = (std::uint64_t(trailer->locationCount) + 1) * sizeof(std::uint32_t);
+    std::uint64_t schemaBytes = std::uint64_t(trailer->columnCount) * sizeof(ColumnDescriptor);
+    std::uint64_t entryBytes = (std::uint64_t(trailer->columnCount) + 1) * sizeof(std::uint64_t);
+    if (trailer->dictionaryOffset % 8 != 0 || trailer->schemaOffset % 8 != 0
+        || trailer->dictionaryOffset < sizeof(ColumnFileHeader)
+        || trailer->dictionaryOffset > trailer->schemaOffset
+        || dictionaryBytes > trailer->schemaOffset - trailer->dictionaryOffset
+        || trailer->schemaOffset > footerEnd
+        || schemaBytes > footerEnd - trailer->schemaOffset) {
+        return false;
+    }
+    std::uint64_t directoryBytes = footerEnd - trailer->schemaOffset - schemaBytes;
+    if (directoryBytes % entryBytes != 0 || directoryBytes / entryBytes != trailer->rowGroupCount) {
+        return false;
+    }
+
+    nameOffsets = reinterpret_cast<const std::uint32_t*>(base + trailer->dictionaryOffset);
+    names = base + trailer->dictionaryOffset + dictionaryBytes;
+    for (std::uint32_t i = 0; i < trailer->locationCount; ++i) {
+        if (nameOffsets[i] > nameOffsets[i + 1]) {
+            return false;
+        }
+    }
+    if (nameOffsets[trailer->locationCount] > trailer->schemaOffset - trailer->dictionaryOffset - dictionaryBytes) {
+        return false;
+    }
+
+    schema = reinterpret_cast<const ColumnDescriptor*>(base + trailer->schemaOffset);
+    directory = reinterpret_cast<const std::uint64_t*>(schema + trailer->columnCount);
+
+    // Every chunk must fit in the data area
+    std::uint64_t rows = 0;
+    for (std::uint32_t g = 0; g < trailer->rowGroupCount; ++g) {
+        const std::uint64_t* entry = directory + std::uint64_t(g) * (std::uint64_t(trailer->columnCount) + 1);
+        for (std::uint32_t c = 0; c < trailer->columnCount; ++c) {
+            if (entry[c + 1] % 8 != 0 || entry[c + 1] < sizeof(ColumnFileHeader) || entry[c + 1] > trailer->dictionaryOffset
+                || entry[0] > (trailer->dictionaryOffset - entry[c + 1]) / (schema[c].width ? schema[c].width : 1)) {
+                return false;
+            }
+        }
+        if (entry[0] > trailer->rowCount - rows) {
+            return false;
+        }
+        rows += entry[0];
+    }
+    if (rows != trailer->rowCount) {
+        return false;
+    }
+
+    // Bind the standard columns by name; a type mismatch counts as absent
+    for (int c = 0; c < STANDARD_COLUMN_COUNT; ++c) {
+        int column = findColumn(STANDARD_COLUMNS[c].name);
+        if (column >= 0 && schema[column].type == static_cast<std::uint32_t>(STANDARD_COLUMNS[c].type)
+            && schema[column].width == STANDARD_COLUMNS[c].width) {
+            standardColumns[c] = column;
+        }
+    }
+
+    return true;
+}
+
+std::size_t RideColumnReader::getRowGroupSize(std::size_t group) const {
+    return static_cast<std::size_t>(directory[group * (std::uint64_t(trailer->columnCount) + 1)]);
+}
+
+std::string RideColumnReader::getColumnName(std::size_t column) const {
+    const char* name = schema[column].name;
+    const void* end = std::memchr(name, '\0', sizeof(schema[column].name));
+    return std::string(name, end ? static_cast<const char*>(end) : name + sizeof(schema[column].name));
+}
+
+int RideColumnReader::findColumn(const std::string& name) const {
+    for (std::uint32_t c = 0; c < trailer->columnCount; ++c) {
+        if (getColumnName(c) == name) {
+            return static_cast<int>(c);
+        }
+    }
+    return -1;
+}
+
+const void* RideColumnReader::chunk(std::size_t group, int column) const {
+    if (column < 0) {
+        return nullptr;
+    }
+    return file.begin() + directory[group * (std::uint64_t(trailer->columnCount) + 1) + 1 + column];
+}
+
+const std::int32_t* RideColumnReader::getRideIDs(std::size_t group) const {
+    return static_cast<const std::int32_t*>(chunk(group, standardColumns[static_cast<int>(RideColumn::RideID)]));
+}
+
+const std::uint8_t* RideColumnReader::getRideTypes(std::size_t group) const {
+    return static_cast<const std::uint8_t*>(chunk(group, standardColumns[static_cast<int>(RideColumn::Type)]));
+}
+
+const std::uint32_t* RideColumnReader::getPickups(std::size_t group) const {
+    return static_cast<const std::uint32_t*>(chunk(group, standardColumns[static_cast<int>(RideColumn::Pickup)]));
+}
+
+const std::uint32_t* RideColumnReader::getDropoffs(std::size_t group) const {
+    return static_cast<const std::uint32_t*>(chunk(group, standardColumns[static_cast<int>(RideColumn::Dropoff)]));
+}
+
+const double* RideColumnReader::getDistances(std::size_t group) const {
+    return static_cast<const double*>(chunk(group, standardColumns[static_cast<int>(RideColumn::Distance)]));
+}
+
+const double* RideColumnReader::getFares(std::size_t group) const {
+    return static_cast<const double*>(chunk(group, standardColumns[static_cast<int>(RideColumn::Fare)]));
+}
+
+std::string RideColumnReader::getLocationName(std::uint32_t index) const {
+    if (index >= trailer->locationCount) {
+        return std::string(); // Corrupt index
+    }
+    return std::string(names + nameOffsets[index], nameOffsets[index + 1] - nameOffsets[index]);
+}
+
+LocationID RideColumnReader::resolveLocation(std::uint32_t index) const {
+    if (index >= trailer->locationCount) {
+        return INVALID_LOCATION; // Corrupt index: do not intern an empty name
+    }
+    return LocationTable::global().intern(getLocationName(index));
+}
@@ -0,0 +1,181 @@
+#ifndef RIDECOLUMNS_H
+#define RIDECOLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "Ride.h"
+#include "MappedFile.h"
+#include "LocationTable.h"
+
+// Columnar ride export for analytics tools. File layout (little-endian):
+//   ColumnFileHeader
+//   row group 0: one chunk per column     fixed-width values, each chunk 8-byte aligned
+//   row group 1, ...
+//   location dictionary                    uint32 offsets[locationCount + 1], then name bytes
+//   schema                                 ColumnDescriptor per column
+//   row group directory                    per group: uint64 rows, uint64 chunk offset per column
+//   ColumnFileTrailer
+// Pickup and dropoff hold indices into the file's own location dictionary, so every
+// location name is stored once. A file without a valid trailer is incomplete and rejected.
+enum class ColumnType : std::uint32_t {
+    Int32 = 1,
+    UInt8 = 2,
+    Float64 = 3,
+    Dictionary = 4  // uint32 index into the location dictionary
+};
+
+// Columns written by RideColumnWriter
+enum class RideColumn {
+    RideID,     // Int32
+    Type,       // UInt8 (RideType)
+    Pickup,     // Dictionary
+    Dropoff,    // Dictionary
+    Distance,   // Float64
+    Fare,       // Float64
+    Count
+};
+
+struct ColumnFileHeader {
+    char magic[8];              // "RIDECOL1"
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+struct ColumnDescriptor {
+    char name[24];              // NUL-padded
+    std::uint32_t type;         // ColumnType
+    std::uint32_t width;        // Bytes per value
+};
+
+struct ColumnFileTrailer {
+    std::uint64_t rowCount;
+    std::uint64_t dictionaryOffset;
+    std::uint64_t schemaOffset; // Schema, immediately followed by the row group directory
+    std::uint32_t locationCount;
+    std::uint32_t columnCount;
+    std::uint32_t rowGroupCount;
+    std::uint32_t version;
+    char magic[8];              // "RIDECOL1"
+};
+
+static_assert(sizeof(ColumnFileHeader) == 16, "ColumnFileHeader layout is part of the file format");
+static_assert(sizeof(ColumnDescriptor) == 32, "ColumnDescriptor layout is part of the file format");
+static_assert(sizeof(ColumnFileTrailer) == 48, "ColumnFileTrailer layout is part of the file format");
+
+// Writes rides column by column. Rows are buffered per column and written as one row
+// group every rowGroupRows rides; the dictionary, schema and directory follow on close().
+class RideColumnWriter {
+private:
+    static const std::uint32_t NO_ID = 0xFFFFFFFFu;
+
+    std::FILE* file;
+    std::size_t rowGroupRows;
+    std::uint64_t offset;
+    std::uint64_t rowCount;
+    bool failed;
+
+    std::vector<std::int32_t> rideIDs;
+    std::vector<std::uint8_t> types;
+    std::vector<std::uint32_t> pickups;
+    std::vector<std::uint32_t> dropoffs;
+    std::vector<double> distances;
+    std::vector<double> fares;
+
+    std::vector<std::uint64_t> directory;           // Row group directory, as written
+    std::vector<std::uint32_t> fileLocationIDs;     // Process LocationID -> dictionary index
+    std::vector<LocationID> dictionary;             // Dictionary index -> process LocationID
+
+    std::uint32_t fileLocation(LocationID location);
+    bool writeBytes(const void* bytes, std::size_t size);
+    bool writeChunk(const void* bytes, std::size_t size); // Pads to 8 bytes
+    bool flushRowGroup();
+
+    RideColumnWriter(const RideColumnWriter&);            // Non-copyable
+    RideColumnWriter& operator=(const RideColumnWriter&);
+
+public:
+    static const std::size_t DEFAULT_ROW_GROUP_ROWS = 64 * 1024;
+
+    // Constructor creates (truncates) the file
+    explicit RideColumnWriter(const std::string& path, std::size_t rowsPerGroup = DEFAULT_ROW_GROUP_ROWS);
+
+    // Destructor calls close()
+    ~RideColumnWriter();
+
+    bool isOpen() const { return file != nullptr; }
+
+    void append(const Ride& ride);
+
+    // Append every ride of a RideRange, FilteredRideRange or container of Ride pointers
+    template <typename Range>
+    void appendAll(const Range& rides) {
+        for (auto it = rides.begin(); it != rides.end(); ++it) {
+            append(deref(*it));
+        }
+    }
+
+    // Write the last row group and the footer; returns false if any write failed
+    bool close();
+
+    std::uint64_t getRowsWritten() const { return rowCount; }
+
+private:
+    static const Ride& deref(const Ride& ride) { return ride; }
+    template <typename Pointer>
+    static const Ride& deref(const Pointer& ride) { return *ride; }
+};
+
+// Memory-maps a column file and hands out typed pointers straight into the mapping,
+// so loading a column costs no parsing or copying. Columns are located by name, which
+// lets older readers skip columns added later.
+class RideColumnReader {
+private:
+    MappedFile file;
+    const ColumnFileTrailer* trailer;
+    const ColumnDescriptor* schema;
+    const std::uint64_t* directory;
+    const std::uint32_t* nameOffsets;
+    const char* names;
+    int standardColumns[static_cast<int>(RideColumn::Count)];
+
+    bool validate();
+    const void* chunk(std::size_t group, int column) const;
+
+    RideColumnReader(const RideColumnReader&);            // Non-copyable
+    RideColumnReader& operator=(const RideColumnReader&);
+
+public:
+    // Constructor maps and validates the file; check isOpen()
+    explicit RideColumnReader(const std::string& path);
+
+    bool isOpen() const { return trailer != nullptr; }
+
+    std::uint64_t getRowCount() const { return trailer->rowCount; }
+    std::size_t getRowGroupCount() const { return trailer->rowGroupCount; }
+    std::size_t getRowGroupSize(std::size_t group) const;
+
+    // Self-description
+    std::size_t getColumnCount() const { return trailer->columnCount; }
+    std::string getColumnName(std::size_t column) const;
+    ColumnType getColumnType(std::size_t column) const { return static_cast<ColumnType>(schema[column].type); }
+    int findColumn(const std::string& name) const; // -1 if absent
+
+    // Column chunks of one row group, getRowGroupSize(group) values each; nullptr if the
+    // file has no such column
+    const std::int32_t* getRideIDs(std::size_t group) const;
+    const std::uint8_t* getRideTypes(std::size_t group) const;   // RideType values
+    const std::uint32_t* getPickups(std::size_t group) const;    // Dictionary indices
+    const std::uint32_t* getDropoffs(std::size_t group) const;
+    const double* getDistances(std::size_t group) const;
+    const double* getFares(std::size_t group) const;
+
+    // Location dictionary
+    std::size_t getLocationCount() const { return trailer->locationCount; }
+    std::string getLocationName(std::uint32_t index) const; // Empty for an out-of-range index
+    LocationID resolveLocation(std::uint32_t index) const; // Interns into LocationTable::global(); INVALID_LOCATION if out of range
+};
+
+#endif // RIDECOLUMNS_H
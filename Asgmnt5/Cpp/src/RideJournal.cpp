@@ -0,0 +1,330 @@
+#include "RideJournal.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char SEGMENT_MAGIC[8] = { 'R', 'I', 'D', 'E', 'L', 'O', 'G', '1' };
+const std::uint32_t JOURNAL_VERSION = 1;
+const std::uint32_t MAX_NAME_BYTES = 64 * 1024; // Longer dictionary names are treated as corruption
+
+std::string segmentPath(const std::string& directory, unsigned index) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/rides-%06u.seg", index);
+    return directory + name;
+}
+
+std::string dictionaryPath(const std::string& directory) {
+    return directory + "/locations.dict";
+}
+
+bool fileExists(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fclose(file);
+    return true;
+}
+
+void makeDirectory(const std::string& path) {
+#ifdef _WIN32
+    _mkdir(path.c_str());
+#else
+    mkdir(path.c_str(), 0755);
+#endif
+}
+
+// Flush stdio buffers and force the data to stable storage
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Cut a file back to its first size bytes
+bool truncateFile(const std::string& path, std::uint64_t size) {
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+    if (file == nullptr) {
+        return false;
+    }
+#ifdef _WIN32
+    bool ok = _chsize_s(_fileno(file), static_cast<long long>(size)) == 0;
+#else
+    bool ok = ftruncate(fileno(file), static_cast<off_t>(size)) == 0;
+#endif
+    std::fclose(file);
+    return ok;
+}
+
+// Reads (id, length, name) entries; calls back with each name in id order. Ids are
+// written as 0, 1, 2, ..., so reading stops at the first entry that is torn (a crash
+// mid-append) or does not fit that pattern. validBytes receives the length of the
+// intact prefix and fileBytes the length of the file.
+template <typename Callback>
+bool readDictionary(const std::string& directory, Callback callback, std::uint64_t& validBytes,
+                    std::uint64_t& fileBytes) {
+    validBytes = 0;
+    fileBytes = 0;
+    std::FILE* file = std::fopen(dictionaryPath(directory).c_str(), "rb");
+    if (file == nullptr) {
+        return true; // No locations written yet
+    }
+
+    std::uint32_t header[2];
+    std::uint32_t expectedID = 0;
+    std::string name;
+    while (std::fread(header, sizeof(header), 1, file) == 1) {
+        if (header[0] != expectedID || header[1] > MAX_NAME_BYTES) {
+            break; // Corrupt entry
+        }
+        name.resize(header[1]);
+        if (header[1] > 0 && std::fread(&name[0], header[1], 1, file) != 1) {
+            break; // Torn final entry
+        }
+        callback(header[0], name);
+        validBytes += sizeof(header) + header[1];
+        ++expectedID;
+    }
+
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+        long size = std::ftell(file);
+        fileBytes = size > 0 ? static_cast<std::uint64_t>(size) : 0;
+    }
+    std::fclose(file);
+    return true;
+}
+
+} // namespace
+
+const std::uint32_t RideJournalWriter::NO_ID;
+
+RideJournalWriter::RideJournalWriter(const std::string& journalDirectory, std::size_t segmentBytes,
+                                     std::size_t commitEvery)
+    : directory(journalDirectory), recordsPerSegment(segmentBytes / sizeof(TripRecord)),
+      groupCommitRecords(commitEvery > 0 ? commitEvery : 1), segment(nullptr), dictionary(nullptr),
+      segmentIndex(0), recordsInSegment(0), nextJournalLocationID(0) {
+    // One record's worth of each segment is the header; keep room for at least one record
+    recordsPerSegment = recordsPerSegment > 2 ? recordsPerSegment - 1 : 1;
+    buffer.reserve(groupCommitRecords);
+    makeDirectory(directory);
+
+    if (!loadDictionary()) {
+        return;
+    }
+    dictionary = std::fopen(dictionaryPath(directory).c_str(), "ab");
+    if (dictionary == nullptr) {
+        std::cout << "Cannot open journal dictionary in " << directory << std::endl;
+        return;
+    }
+
+    // Continue after the last existing segment; old segments are never reopened for writing
+    while (fileExists(segmentPath(directory, segmentIndex + 1))) {
+        ++segmentIndex;
+    }
+    openNextSegment();
+}
+
+RideJournalWriter::~RideJournalWriter() {
+    commit();
+    if (segment != nullptr) {
+        std::fclose(segment);
+    }
+    if (dictionary != nullptr) {
+        std::fclose(dictionary);
+    }
+}
+
+bool RideJournalWriter::loadDictionary() {
+    LocationTable& table = LocationTable::global();
+    std::uint64_t validBytes, fileBytes;
+    bool loaded = readDictionary(directory, [&](std::uint32_t journalID, const std::string& name) {
+        nextJournalLocationID = journalID + 1; // Entries arrive in id order
+        LocationID location = table.intern(name);
+        if (location == INVALID_LOCATION) {
+            return;
+        }
+        if (location >= journalLocationIDs.size()) {
+            journalLocationIDs.resize(location + 1, NO_ID);
+        }
+        journalLocationIDs[location] = journalID;
+    }, validBytes, fileBytes);
+
+    // Drop a torn tail left by a crash, or new entries would be appended after it and
+    // never read back
+    if (loaded && fileBytes > validBytes && !truncateFile(dictionaryPath(directory), validBytes)) {
+        std::cout << "Cannot repair journal dictionary in " << directory << std::endl;
+        return false;
+    }
+    return loaded;
+}
+
+bool RideJournalWriter::openNextSegment() {
+    if (segment != nullptr) {
+        syncFile(segment);
+        std::fclose(segment);
+        segment = nullptr;
+    }
+
+    ++segmentIndex;
+    std::string path = segmentPath(directory, segmentIndex);
+    segment = std::fopen(path.c_str(), "wb");
+    if (segment == nullptr) {
+        std::cout << "Cannot create journal segment " << path << std::endl;
+        return false;
+    }
+    std::setvbuf(segment, nullptr, _IONBF, 0); // Records are already buffered in groups
+
+    JournalSegmentHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC));
+    header.version = JOURNAL_VERSION;
+    header.recordSize = sizeof(TripRecord);
+    header.segmentIndex = segmentIndex;
+    recordsInSegment = 0;
+    return std::fwrite(&header, sizeof(header), 1, segment) == 1;
+}
+
+std::uint32_t RideJournalWriter::journalLocation(LocationID location) {
+    if (location == INVALID_LOCATION) {
+        return NO_ID; // Reads back as INVALID_LOCATION
+    }
+    if (location >= journalLocationIDs.size()) {
+        journalLocationIDs.resize(location + 1, NO_ID);
+    }
+    if (journalLocationIDs[location] == NO_ID) {
+        // First use in this journal: append the name; it is synced before the records using it
+        const std::string& name = LocationTable::global().name(location);
+        std::uint32_t entry[2] = { nextJournalLocationID, static_cast<std::uint32_t>(name.size()) };
+        std::fwrite(entry, sizeof(entry), 1, dictionary);
+        std::fwrite(name.data(), 1, name.size(), dictionary);
+        journalLocationIDs[location] = nextJournalLocationID++;
+    }
+    return journalLocationIDs[location];
+}
+
+void RideJournalWriter::append(const Ride& ride, int driverID, int riderID) {
+    append(makeTripRecord(ride, driverID, riderID));
+}
+
+void RideJournalWriter::append(const TripRecord& record) {
+    if (!isOpen()) {
+        return;
+    }
+    TripRecord stored = record;
+    stored.pickup = journalLocation(record.pickup);
+    stored.dropoff = journalLocation(record.dropoff);
+    buffer.push_back(stored);
+    if (buffer.size() >= groupCommitRecords) {
+        commit();
+    }
+}
+
+bool RideJournalWriter::commit() {
+    if (!isOpen() || buffer.empty()) {
+        return isOpen();
+    }
+
+    // Names must be durable before any record that refers to them
+    if (!syncFile(dictionary)) {
+        std::cout << "Journal dictionary sync failed" << std::endl;
+        return false;
+    }
+
+    std::size_t written = 0;
+    while (written < buffer.size()) {
+        if (recordsInSegment == recordsPerSegment && !openNextSegment()) {
+            return false;
+        }
+        std::size_t room = recordsPerSegment - recordsInSegment;
+        std::size_t batch = buffer.size() - written < room ? buffer.size() - written : room;
+        if (std::fwrite(&buffer[written], sizeof(TripRecord), batch, segment) != batch) {
+            std::cout << "Journal write failed" << std::endl;
+            return false;
+        }
+        recordsInSegment += batch;
+        written += batch;
+    }
+    buffer.clear();
+
+    if (!syncFile(segment)) {
+        std::cout << "Journal segment sync failed" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+RideJournalReader::RideJournalReader(const std::string& journalDirectory) {
+    loadDictionary(journalDirectory);
+
+    for (unsigned index = 1;; ++index) {
+        std::unique_ptr<MappedFile> file(new MappedFile());
+        if (!file->open(segmentPath(journalDirectory, index))) {
+            break;
+        }
+
+        const JournalSegmentHeader* header = reinterpret_cast<const JournalSegmentHeader*>(file->begin());
+        if (file->size() < sizeof(JournalSegmentHeader)
+            || std::memcmp(header->magic, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) != 0
+            || header->recordSize != sizeof(TripRecord)) {
+            std::cout << "Skipping invalid journal segment " << index << std::endl;
+            continue;
+        }
+        segments.push_back(std::move(file));
+    }
+}
+
+bool RideJournalReader::loadDictionary(const std::string& directory) {
+    LocationTable& table = LocationTable::global();
+    std::uint64_t validBytes, fileBytes;
+    return readDictionary(directory, [&](std::uint32_t journalID, const std::string& name) {
+        if (journalID >= locations.size()) {
+            locations.resize(journalID + 1, INVALID_LOCATION);
+        }
+        locations[journalID] = table.intern(name);
+    }, validBytes, fileBytes);
+}
+
+const TripRecord* RideJournalReader::getRecords(std::size_t segmentIndex, std::size_t& count) const {
+    const MappedFile& file = *segments[segmentIndex];
+    count = file.size() / sizeof(TripRecord) - 1; // Minus the header
+    return reinterpret_cast<const TripRecord*>(file.begin() + sizeof(JournalSegmentHeader));
+}
+
+std::size_t RideJournalReader::getRecordCount() const {
+    std::size_t total = 0;
+    for (std::size_t s = 0; s < segments.size(); ++s) {
+        std::size_t count = 0;
+        getRecords(s, count);
+        total += count;
+    }
+    return total;
+}
+
+void RideJournalReader::rebuildAggregates(const std::unordered_map<int, Driver*>& drivers,
+                                          const std::unordered_map<int, Rider*>& riders) const {
+    forEach([&](const TripRecord& record) {
+        std::unordered_map<int, Driver*>::const_iterator driver = drivers.find(record.driverID);
+        if (driver != drivers.end()) {
+            driver->second->replayRide(record.getRideType(), record.fare);
+        }
+        std::unordered_map<int, Rider*>::const_iterator rider = riders.find(record.riderID);
+        if (rider != riders.end()) {
+            rider->second->replayRequest(record.getRideType(), record.fare);
+        }
+    });
+}
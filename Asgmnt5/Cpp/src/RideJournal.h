@@ -0,0 +1,116 @@
+#ifndef RIDEJOURNAL_H
+#define RIDEJOURNAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TripRecord.h"
+#include "MappedFile.h"
+#include "LocationTable.h"
+#include "Driver.h"
+#include "Rider.h"
+
+// On-disk layout of a journal directory:
+//   rides-000001.seg, rides-000002.seg, ...  segment files: one SegmentHeader then TripRecords
+//   locations.dict                            append-only (id, length, name) entries
+// Location ids inside records are journal-wide ids from locations.dict, so a journal
+// stays valid across processes whose LocationTable assigns different ids.
+struct JournalSegmentHeader {
+    char magic[8];              // "RIDELOG1"
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t segmentIndex;
+    char reserved[24];          // Pads the header to one record so records stay aligned
+};
+
+static_assert(sizeof(JournalSegmentHeader) == sizeof(TripRecord), "Segment header must be one record long");
+
+// Appends rides to the journal. Records are buffered and written in groups, each group
+// followed by a single fsync (group commit). A new segment file is started whenever the
+// current one reaches its size limit.
+class RideJournalWriter {
+private:
+    static const std::uint32_t NO_ID = 0xFFFFFFFFu;
+
+    std::string directory;
+    std::size_t recordsPerSegment;
+    std::size_t groupCommitRecords;
+    std::FILE* segment;
+    std::FILE* dictionary;
+    unsigned segmentIndex;
+    std::size_t recordsInSegment;
+    std::vector<TripRecord> buffer;
+    std::vector<std::uint32_t> journalLocationIDs; // Process LocationID -> journal id
+    std::uint32_t nextJournalLocationID;
+
+    bool loadDictionary();
+    bool openNextSegment();
+    std::uint32_t journalLocation(LocationID location);
+
+    RideJournalWriter(const RideJournalWriter&);            // Non-copyable
+    RideJournalWriter& operator=(const RideJournalWriter&);
+
+public:
+    // Constructor opens (or creates) the journal directory and starts a new segment
+    RideJournalWriter(const std::string& journalDirectory, std::size_t segmentBytes = 64 * 1024 * 1024,
+                      std::size_t commitEvery = 1024);
+
+    // Destructor commits pending records
+    ~RideJournalWriter();
+
+    bool isOpen() const { return segment != nullptr && dictionary != nullptr; }
+
+    // Queue a ride; commits automatically once a group is full
+    void append(const Ride& ride, int driverID, int riderID);
+    void append(const TripRecord& record); // Locations are process LocationIDs
+
+    // Write all queued records and fsync; returns false on I/O failure
+    bool commit();
+};
+
+// Memory-maps every segment of a journal. Records are used in place, without copying
+// or parsing, so replaying history runs at disk (or page cache) bandwidth.
+class RideJournalReader {
+private:
+    std::vector<std::unique_ptr<MappedFile>> segments;
+    std::vector<LocationID> locations; // Journal id -> process LocationID
+
+    bool loadDictionary(const std::string& directory);
+
+public:
+    // Constructor
+    explicit RideJournalReader(const std::string& journalDirectory);
+
+    std::size_t getSegmentCount() const { return segments.size(); }
+    std::size_t getRecordCount() const;
+
+    // Records of one segment, straight from the mapping; a torn final record is ignored
+    const TripRecord* getRecords(std::size_t segmentIndex, std::size_t& count) const;
+
+    // Invoke callback(const TripRecord&) for every record in journal order
+    template <typename Callback>
+    void forEach(Callback callback) const {
+        for (std::size_t s = 0; s < segments.size(); ++s) {
+            std::size_t count = 0;
+            const TripRecord* records = getRecords(s, count);
+            for (std::size_t i = 0; i < count; ++i) {
+                callback(records[i]);
+            }
+        }
+    }
+
+    // Map a journal location id back to this process's LocationTable
+    LocationID resolveLocation(std::uint32_t journalID) const {
+        return journalID < locations.size() ? locations[journalID] : INVALID_LOCATION;
+    }
+
+    // Rebuild Driver/Rider fare aggregates from the journal; unknown ids are skipped
+    void rebuildAggregates(const std::unordered_map<int, Driver*>& drivers,
+                           const std::unordered_map<int, Rider*>& riders) const;
+};
+
+#endif // RIDEJOURNAL_H
@@ -0,0 +1,121 @@
+#include "RidePool.h"
+
+RidePool::RidePool(std::size_t blockBytes)
+    : blockSize(blockBytes), nextEpochID(0) {
+    beginEpoch();
+}
+
+RidePool::~RidePool() {
+    releaseAll();
+    for (size_t i = 0; i < freeBlocks.size(); ++i) {
+        ::operator delete(freeBlocks[i].memory);
+    }
+}
+
+RidePool::EpochID RidePool::beginEpoch() {
+    Epoch epoch;
+    epoch.id = nextEpochID++;
+    epoch.cursor = nullptr;
+    epoch.limit = nullptr;
+    epochs.push_back(epoch);
+    return epoch.id;
+}
+
+void* RidePool::allocate(std::size_t size, std::size_t alignment) {
+    Epoch& epoch = epochs.back();
+
+    // Align the bump pointer inside the current block
+    std::size_t address = reinterpret_cast<std::size_t>(epoch.cursor);
+    std::size_t padding = (alignment - address % alignment) % alignment;
+
+    if (epoch.cursor == nullptr || padding + size > static_cast<std::size_t>(epoch.limit - epoch.cursor)) {
+        Block block = acquireBlock(size + alignment);
+        epoch.blocks.push_back(block);
+        epoch.cursor = block.memory;
+        epoch.limit = block.memory + block.size;
+        address = reinterpret_cast<std::size_t>(epoch.cursor);
+        padding = (alignment - address % alignment) % alignment;
+    }
+
+    char* result = epoch.cursor + padding;
+    epoch.cursor = result + size;
+    return result;
+}
+
+RidePool::Block RidePool::acquireBlock(std::size_t minSize) {
+    if (minSize <= blockSize && !freeBlocks.empty()) {
+        Block block = freeBlocks.back();
+        freeBlocks.pop_back();
+        return block;
+    }
+
+    Block block;
+    block.size = minSize > blockSize ? minSize : blockSize;
+    block.memory = static_cast<char*>(::operator new(block.size));
+    return block;
+}
+
+void RidePool::destroyEpoch(Epoch& epoch) {
+    for (size_t i = 0; i < epoch.rides.size(); ++i) {
+        epoch.rides[i]->~Ride();
+    }
+    epoch.rides.clear();
+
+    // Standard-sized blocks are kept for reuse so long-running processes do not fragment
+    for (size_t i = 0; i < epoch.blocks.size(); ++i) {
+        if (epoch.blocks[i].size == blockSize) {
+            freeBlocks.push_back(epoch.blocks[i]);
+        } else {
+            ::operator delete(epoch.blocks[i].memory);
+        }
+    }
+    epoch.blocks.clear();
+    epoch.cursor = nullptr;
+    epoch.limit = nullptr;
+}
+
+void RidePool::releaseEpoch(EpochID epoch) {
+    for (size_t i = 0; i < epochs.size(); ++i) {
+        if (epochs[i].id == epoch) {
+            bool current = i + 1 == epochs.size();
+            destroyEpoch(epochs[i]);
+            epochs.erase(epochs.begin() + i);
+
+            // Releasing the current epoch opens a fresh one rather than letting an
+            // older, still-live epoch silently become the allocation target
+            if (current) {
+                beginEpoch();
+            }
+            break;
+        }
+    }
+}
+
+void RidePool::releaseAll() {
+    for (size_t i = 0; i < epochs.size(); ++i) {
+        destroyEpoch(epochs[i]);
+    }
+    epochs.clear();
+    beginEpoch();
+}
+
+std::size_t RidePool::getLiveRides() const {
+    std::size_t total = 0;
+    for (size_t i = 0; i < epochs.size(); ++i) {
+        total += epochs[i].rides.size();
+    }
+    return total;
+}
+
+std::size_t RidePool::getReservedBytes() const {
+    std::size_t total = 0;
+    for (size_t i = 0; i < epochs.size(); ++i) {
+        for (size_t j = 0; j < epochs[i].blocks.size(); ++j) {
+            total += epochs[i].blocks[j].size;
+        }
+    }
+    for (size_t i = 0; i < freeBlocks.size(); ++i) {
+        total += freeBlocks[i].size;
+    }
+    return total;
+}
@@ -0,0 +1,83 @@
+#ifndef RIDEPOOL_H
+#define RIDEPOOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+#include "Ride.h"
+
+// Arena allocator for Ride objects.
+// Rides are placement-constructed into large blocks grouped by epoch (for example
+// one dispatch window or one city shard). Creating a ride is a pointer bump, and a
+// whole epoch is destroyed and recycled at once with releaseEpoch().
+class RidePool {
+public:
+    typedef unsigned int EpochID;
+
+private:
+    struct Block {
+        char* memory;
+        std::size_t size;
+    };
+
+    struct Epoch {
+        EpochID id;
+        std::vector<Block> blocks;
+        std::vector<Ride*> rides; // Needed to run destructors on release
+        char* cursor;
+        char* limit;
+    };
+
+    std::size_t blockSize;
+    EpochID nextEpochID;
+    std::vector<Epoch> epochs;      // Last entry is the epoch currently allocating
+    std::vector<Block> freeBlocks;  // Recycled blocks from released epochs
+
+    void* allocate(std::size_t size, std::size_t alignment);
+    Block acquireBlock(std::size_t minSize);
+    void destroyEpoch(Epoch& epoch);
+
+    RidePool(const RidePool&);            // Non-copyable
+    RidePool& operator=(const RidePool&);
+
+public:
+    // Constructor
+    explicit RidePool(std::size_t blockBytes = 64 * 1024);
+
+    // Destructor releases every epoch still alive
+    ~RidePool();
+
+    // Start a new epoch; subsequent rides are allocated into it
+    EpochID beginEpoch();
+    EpochID currentEpoch() const { return epochs.back().id; }
+
+    // Construct a ride of type T inside the current epoch
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* memory = allocate(sizeof(T), alignof(T));
+        T* ride = new (memory) T(std::forward<Args>(args)...);
+        epochs.back().rides.push_back(ride);
+        return ride;
+    }
+
+    // Non-owning handle usable with the shared_ptr based Driver/Rider API.
+    // It has no control block, so copying it never touches a reference count.
+    // The handle must not be used after the ride's epoch has been released.
+    template <typename T>
+    static std::shared_ptr<T> handle(T* ride) {
+        return std::shared_ptr<T>(std::shared_ptr<T>(), ride);
+    }
+
+    // Destroy all rides of an epoch and recycle its blocks. Releasing the current
+    // epoch starts a new one, so later rides never land in an older epoch.
+    void releaseEpoch(EpochID epoch);
+    void releaseAll();
+
+    // Statistics
+    std::size_t getLiveRides() const;
+    std::size_t getReservedBytes() const;
+};
+
+#endif // RIDEPOOL_H
@@ -0,0 +1,192 @@
+#include "RideRegistry.h"
+#include <iostream>
+
+const std::uint32_t RideRegistry::NO_SLOT;
+
+RideRegistry::RideRegistry(std::size_t expectedRides) : freeSlots(NO_SLOT), mask(0), count(0) {
+    reserve(expectedRides);
+}
+
+std::size_t RideRegistry::hashID(int rideID) {
+    // Fibonacci hashing spreads sequential ids over the table
+    std::uint64_t h = static_cast<std::uint32_t>(rideID) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::size_t>(h ^ (h >> 32));
+}
+
+void RideRegistry::reserve(std::size_t rides) {
+    // Keep the load factor at or below 1/2
+    std::size_t capacity = 16;
+    while (capacity < rides * 2) {
+        capacity <<= 1;
+    }
+    if (capacity > buckets.size()) {
+        rehash(capacity);
+    }
+    slots.reserve(rides);
+}
+
+void RideRegistry::rehash(std::size_t capacity) {
+    std::vector<Bucket> old;
+    old.swap(buckets);
+    Bucket empty = { 0, NO_SLOT };
+    buckets.assign(capacity, empty);
+    mask = capacity - 1;
+    for (size_t i = 0; i < old.size(); ++i) {
+        if (old[i].slot != NO_SLOT) {
+            insertBucket(old[i].rideID, old[i].slot);
+        }
+    }
+}
+
+std::size_t RideRegistry::findBucket(int rideID) const {
+    for (std::size_t i = hashID(rideID) & mask;; i = (i + 1) & mask) {
+        if (buckets[i].slot == NO_SLOT) {
+            return buckets.size();
+        }
+        if (buckets[i].rideID == rideID) {
+            return i;
+        }
+    }
+}
+
+void RideRegistry::insertBucket(int rideID, std::uint32_t slot) {
+    std::size_t i = hashID(rideID) & mask;
+    while (buckets[i].slot != NO_SLOT) {
+        i = (i + 1) & mask;
+    }
+    buckets[i].rideID = rideID;
+    buckets[i].slot = slot;
+}
+
+void RideRegistry::eraseBucket(std::size_t bucket) {
+    // Backward-shift deletion: pull later entries of the probe run into the hole
+    std::size_t hole = bucket;
+    for (std::size_t i = (hole + 1) & mask; buckets[i].slot != NO_SLOT; i = (i + 1) & mask) {
+        std::size_t home = hashID(buckets[i].rideID) & mask;
+        // Move the entry unless its home lies cyclically within (hole, i]
+        bool homeInRange = hole <= i ? (home > hole && home <= i) : (home > hole || home <= i);
+        if (!homeInRange) {
+            buckets[hole] = buckets[i];
+            hole = i;
+        }
+    }
+    buckets[hole].slot = NO_SLOT;
+}
+
+RideHandle RideRegistry::add(std::shared_ptr<Ride> ride, Driver* driver, Rider* rider) {
+    if (!ride) {
+        return invalidHandle();
+    }
+    if (findBucket(ride->getRideID()) != buckets.size()) {
+        std::cout << "Ride " << ride->getRideID() << " is already registered" << std::endl;
+        return invalidHandle();
+    }
+    if ((count + 1) * 2 > buckets.size()) {
+        rehash(buckets.size() * 2);
+    }
+
+    std::uint32_t slot;
+    if (freeSlots != NO_SLOT) {
+        slot = freeSlots;
+        freeSlots = slots[slot].nextFree;
+    } else {
+        slot = static_cast<std::uint32_t>(slots.size());
+        Slot fresh;
+        fresh.driver = nullptr;
+        fresh.rider = nullptr;
+        fresh.generation = 1;
+        fresh.nextFree = NO_SLOT;
+        slots.push_back(fresh);
+    }
+
+    Slot& entry = slots[slot];
+    entry.ride = ride;
+    entry.driver = driver;
+    entry.rider = rider;
+    entry.nextFree = NO_SLOT;
+    insertBucket(ride->getRideID(), slot);
+    ++count;
+
+    RideHandle handle = { slot, entry.generation };
+    return handle;
+}
+
+const RideRegistry::Slot* RideRegistry::slotFor(RideHandle handle) const {
+    if (handle.slot >= slots.size()) {
+        return nullptr;
+    }
+    const Slot& entry = slots[handle.slot];
+    return entry.generation == handle.generation && entry.ride ? &entry : nullptr;
+}
+
+bool RideRegistry::find(int rideID, RideHandle& handle) const {
+    std::size_t bucket = findBucket(rideID);
+    if (bucket == buckets.size()) {
+        return false;
+    }
+    handle.slot = buckets[bucket].slot;
+    handle.generation = slots[handle.slot].generation;
+    return true;
+}
+
+Ride* RideRegistry::get(RideHandle handle) const {
+    const Slot* entry = slotFor(handle);
+    return entry ? entry->ride.get() : nullptr;
+}
+
+Driver* RideRegistry::getDriver(RideHandle handle) const {
+    const Slot* entry = slotFor(handle);
+    return entry ? entry->driver : nullptr;
+}
+
+Rider* RideRegistry::getRider(RideHandle handle) const {
+    const Slot* entry = slotFor(handle);
+    return entry ? entry->rider : nullptr;
+}
+
+void RideRegistry::release(RideHandle handle) {
+    Slot& entry = slots[handle.slot];
+    eraseBucket(findBucket(entry.ride->getRideID()));
+    entry.ride.reset();
+    entry.driver = nullptr;
+    entry.rider = nullptr;
+    ++entry.generation; // Invalidates every outstanding handle to this slot
+    entry.nextFree = freeSlots;
+    freeSlots = handle.slot;
+    --count;
+}
+
+bool RideRegistry::cancel(RideHandle handle) {
+    const Slot* entry = slotFor(handle);
+    if (entry == nullptr) {
+        std::cout << "Cannot cancel: unknown or already cancelled ride" << std::endl;
+        return false;
+    }
+
+    if (entry->driver) {
+        entry->driver->removeRide(*entry->ride);
+    }
+    if (entry->rider) {
+        entry->rider->removeRequest(*entry->ride);
+    }
+    release(handle);
+    return true;
+}
+
+bool RideRegistry::reassign(RideHandle handle, Driver& newDriver) {
+    if (slotFor(handle) == nullptr) {
+        std::cout << "Cannot reassign: unknown or cancelled ride" << std::endl;
+        return false;
+    }
+
+    Slot& entry = slots[handle.slot];
+    if (entry.driver == &newDriver) {
+        return true;
+    }
+    if (entry.driver) {
+        entry.driver->removeRide(*entry.ride);
+    }
+    newDriver.recordRide(entry.ride);
+    entry.driver = &newDriver;
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef RIDEREGISTRY_H
+#define RIDEREGISTRY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "Ride.h"
+#include "Driver.h"
+#include "Rider.h"
+
+// Reference to a registered ride. The generation makes handles to cancelled rides
+// fail cleanly even after their slot has been reused.
+struct RideHandle {
+    std::uint32_t slot;
+    std::uint32_t generation;
+};
+
+// Central index of live rides: rideID -> handle -> (ride, driver, rider).
+// Lookup is an open-addressing hash table with linear probing and backward-shift
+// deletion (no tombstones), so cancellations never degrade probing. Rides live in a
+// slot array recycled through a free list; memory is two flat arrays (40 bytes per slot plus 16-32 bytes
+// of table per live ride, besides the ride itself) and never fragments.
+//
+// Register rides after they are added to their driver and rider; cancel() and
+// reassign() then keep both histories and their fare aggregates consistent.
+class RideRegistry {
+private:
+    static const std::uint32_t NO_SLOT = 0xFFFFFFFFu;
+
+    struct Slot {
+        std::shared_ptr<Ride> ride;
+        Driver* driver;
+        Rider* rider;
+        std::uint32_t generation;
+        std::uint32_t nextFree;
+    };
+
+    struct Bucket {
+        int rideID;
+        std::uint32_t slot; // NO_SLOT when empty
+    };
+
+    std::vector<Slot> slots;
+    std::uint32_t freeSlots;
+    std::vector<Bucket> buckets;
+    std::size_t mask;
+    std::size_t count;
+
+    static std::size_t hashID(int rideID);
+    std::size_t findBucket(int rideID) const; // Index of the bucket holding rideID, or buckets.size()
+    void insertBucket(int rideID, std::uint32_t slot);
+    void eraseBucket(std::size_t bucket);
+    void rehash(std::size_t capacity);
+    const Slot* slotFor(RideHandle handle) const;
+    void release(RideHandle handle);
+
+public:
+    // Constructor
+    explicit RideRegistry(std::size_t expectedRides = 1024);
+
+    // Make room for this many rides without rehashing
+    void reserve(std::size_t rides);
+
+    // Register a ride already recorded by its driver and rider (either may be null).
+    // Fails (invalid handle) if the ride id is already registered.
+    RideHandle add(std::shared_ptr<Ride> ride, Driver* driver, Rider* rider);
+
+    // O(1) lookups; false / nullptr for unknown ids and stale handles
+    bool find(int rideID, RideHandle& handle) const;
+    bool isValid(RideHandle handle) const { return slotFor(handle) != nullptr; }
+    Ride* get(RideHandle handle) const;
+    Driver* getDriver(RideHandle handle) const;
+    Rider* getRider(RideHandle handle) const;
+
+    // Remove the ride from its driver's and rider's histories and aggregates and
+    // unregister it; the handle becomes stale
+    bool cancel(RideHandle handle);
+
+    // Move the ride to another driver; earnings move with it
+    bool reassign(RideHandle handle, Driver& newDriver);
+
+    std::size_t size() const { return count; }
+
+    // Handle that never refers to a ride
+    static RideHandle invalidHandle() { RideHandle handle = { NO_SLOT, 0 }; return handle; }
+};
+
+#endif // RIDEREGISTRY_H
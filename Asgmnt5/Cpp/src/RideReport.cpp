@@ -0,0 +1,205 @@
+#include "RideReport.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "FarePolicy.h"
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#include <charconv>
+#endif
+
+namespace {
+
+const char* const TYPE_NAMES[RIDE_TYPE_COUNT] = { "Standard", "Premium" };
+
+const char* typeName(RideType type) {
+    return TYPE_NAMES[static_cast<int>(type)];
+}
+
+} // namespace
+
+RideReportWriter::RideReportWriter(std::ostream& out, ReportFormat reportFormat, std::size_t blockSize)
+    : format(reportFormat), stream(&out), buffer(ownBuffer), blockBytes(blockSize), written(0), open(false) {
+    buffer.reserve(blockBytes + 1024);
+}
+
+RideReportWriter::RideReportWriter(std::string& target, ReportFormat reportFormat)
+    : format(reportFormat), stream(nullptr), buffer(target), blockBytes(0), written(0), open(false) {
+}
+
+RideReportWriter::~RideReportWriter() {
+    if (open) {
+        end();
+    }
+}
+
+void RideReportWriter::formatNumber(double value, std::string& out) {
+    char digits[32];
+#if defined(__cpp_lib_to_chars)
+    std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+#else
+    // Try 15 significant digits first; fall back to 17, which always round-trips
+    int length = std::snprintf(digits, sizeof(digits), "%.15g", value);
+    if (std::strtod(digits, nullptr) != value) {
+        length = std::snprintf(digits, sizeof(digits), "%.17g", value);
+    }
+    out.append(digits, static_cast<std::size_t>(length));
+#endif
+}
+
+void RideReportWriter::appendNumber(double value) {
+    if (format == ReportFormat::Json && !std::isfinite(value)) {
+        buffer += "null";
+        return;
+    }
+    if (format == ReportFormat::Text) {
+        // Same 6 significant digits as the console output of rideDetails()
+        char digits[32];
+        int length = std::snprintf(digits, sizeof(digits), "%g", value);
+        buffer.append(digits, static_cast<std::size_t>(length));
+        return;
+    }
+    formatNumber(value, buffer);
+}
+
+void RideReportWriter::appendInteger(long long value) {
+    char digits[24];
+    int length = std::snprintf(digits, sizeof(digits), "%lld", value);
+    buffer.append(digits, static_cast<std::size_t>(length));
+}
+
+void RideReportWriter::appendText(const std::string& text) {
+    if (format == ReportFormat::Text) {
+        buffer += text;
+    } else if (format == ReportFormat::Csv) {
+        if (text.find_first_of(",\"\r\n") == std::string::npos) {
+            buffer += text;
+            return;
+        }
+        buffer += '"';
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '"') {
+                buffer += '"';
+            }
+            buffer += text[i];
+        }
+        buffer += '"';
+    } else {
+        buffer += '"';
+        for (std::size_t i = 0; i < text.size(); ++i) {
+            unsigned char c = static_cast<unsigned char>(text[i]);
+            if (c == '"' || c == '\\') {
+                buffer += '\\';
+                buffer += static_cast<char>(c);
+            } else if (c == '\n') {
+                buffer += "\\n";
+            } else if (c < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                buffer += escaped;
+            } else {
+                buffer += static_cast<char>(c);
+            }
+        }
+        buffer += '"';
+    }
+}
+
+void RideReportWriter::spill() {
+    if (stream != nullptr && !buffer.empty()) {
+        stream->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+void RideReportWriter::begin() {
+    if (open) {
+        return;
+    }
+    open = true;
+    written = 0;
+    if (format == ReportFormat::Csv) {
+        buffer += "rideID,type,pickup,dropoff,distance,surge,fare,requestTime\n";
+    } else if (format == ReportFormat::Json) {
+        buffer += '[';
+    }
+}
+
+void RideReportWriter::write(const Ride& ride) {
+    begin();
+
+    if (format == ReportFormat::Text) {
+        buffer += "Ride ";
+        appendInteger(ride.getRideID());
+        buffer += " | ";
+        buffer += typeName(ride.getRideType());
+        buffer += " | ";
+        appendText(ride.getPickupLocation());
+        buffer += " -> ";
+        appendText(ride.getDropoffLocation());
+        buffer += " | ";
+        appendNumber(ride.getDistance());
+        buffer += " miles | ";
+        if (ride.getSurgeMultiplier() != 1.0) {
+            buffer += 'x';
+            appendNumber(ride.getSurgeMultiplier());
+            buffer += " | ";
+        }
+        buffer += '$';
+        appendNumber(ride.fare());
+        buffer += '\n';
+    } else if (format == ReportFormat::Csv) {
+        appendInteger(ride.getRideID());
+        buffer += ',';
+        buffer += typeName(ride.getRideType());
+        buffer += ',';
+        appendText(ride.getPickupLocation());
+        buffer += ',';
+        appendText(ride.getDropoffLocation());
+        buffer += ',';
+        appendNumber(ride.getDistance());
+        buffer += ',';
+        appendNumber(ride.getSurgeMultiplier());
+        buffer += ',';
+        appendNumber(ride.fare());
+        buffer += ',';
+        appendInteger(static_cast<long long>(ride.getRequestTime()));
+        buffer += '\n';
+    } else {
+        buffer += written == 0 ? "\n" : ",\n";
+        buffer += "  {\"rideID\": ";
+        appendInteger(ride.getRideID());
+        buffer += ", \"type\": \"";
+        buffer += typeName(ride.getRideType());
+        buffer += "\", \"pickup\": ";
+        appendText(ride.getPickupLocation());
+        buffer += ", \"dropoff\": ";
+        appendText(ride.getDropoffLocation());
+        buffer += ", \"distance\": ";
+        appendNumber(ride.getDistance());
+        buffer += ", \"ratePerMile\": ";
+        appendNumber(FARE_TABLE[static_cast<int>(ride.getRideType())].ratePerMile);
+        buffer += ", \"surge\": ";
+        appendNumber(ride.getSurgeMultiplier());
+        buffer += ", \"fare\": ";
+        appendNumber(ride.fare());
+        buffer += ", \"requestTime\": ";
+        appendInteger(static_cast<long long>(ride.getRequestTime()));
+        buffer += '}';
+    }
+    ++written;
+
+    if (stream != nullptr && buffer.size() >= blockBytes) {
+        spill();
+    }
+}
+
+void RideReportWriter::end() {
+    begin(); // An empty report still gets its header / brackets
+    if (format == ReportFormat::Json) {
+        buffer += written == 0 ? "]\n" : "\n]\n";
+    }
+    spill();
+    open = false;
+}
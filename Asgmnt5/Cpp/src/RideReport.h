@@ -0,0 +1,75 @@
+#ifndef RIDEREPORT_H
+#define RIDEREPORT_H
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include "Ride.h"
+
+enum class ReportFormat {
+    Text,   // One aligned line per ride
+    Csv,    // Header row, RFC 4180 quoting
+    Json    // Array of objects
+};
+
+// Renders rides into a memory buffer, either a caller-supplied std::string or an
+// internal one that is handed to an std::ostream in large blocks. Nothing is ever
+// flushed, so exporting a long history costs formatting time, not one syscall per line.
+// CSV and JSON numbers are written in the shortest form that reads back to the same
+// double (std::to_chars when the library has it, snprintf otherwise).
+class RideReportWriter {
+private:
+    static const std::size_t DEFAULT_BLOCK_BYTES = 64 * 1024;
+
+    ReportFormat format;
+    std::ostream* stream;     // Null when rendering into a caller's string
+    std::string ownBuffer;
+    std::string& buffer;
+    std::size_t blockBytes;
+    std::size_t written;      // Rides written since begin()
+    bool open;
+
+    void appendNumber(double value);
+    void appendInteger(long long value);
+    void appendText(const std::string& text);  // Quoted/escaped as the format needs
+    void spill();
+
+    RideReportWriter(const RideReportWriter&);            // Non-copyable
+    RideReportWriter& operator=(const RideReportWriter&);
+
+public:
+    // Render to a stream; output reaches it in blocks of about blockSize bytes
+    RideReportWriter(std::ostream& out, ReportFormat reportFormat, std::size_t blockSize = DEFAULT_BLOCK_BYTES);
+
+    // Render into a caller-supplied string (appended to, never flushed anywhere)
+    RideReportWriter(std::string& target, ReportFormat reportFormat);
+
+    // Destructor calls end() if needed
+    ~RideReportWriter();
+
+    // Header / opening bracket; called automatically by the first write()
+    void begin();
+    void write(const Ride& ride);
+    // Footer / closing bracket, then hand the buffer to the stream (without flushing it)
+    void end();
+
+    // Write every ride of a RideRange, FilteredRideRange or container of Ride pointers
+    template <typename Range>
+    void writeAll(const Range& rides) {
+        for (auto it = rides.begin(); it != rides.end(); ++it) {
+            write(deref(*it));
+        }
+    }
+
+    std::size_t getRidesWritten() const { return written; }
+
+    // Shortest round-trip decimal form of a double
+    static void formatNumber(double value, std::string& out);
+
+private:
+    static const Ride& deref(const Ride& ride) { return ride; }
+    template <typename Pointer>
+    static const Ride& deref(const Pointer& ride) { return *ride; }
+};
+
+#endif // RIDEREPORT_H
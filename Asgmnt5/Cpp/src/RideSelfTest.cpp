@@ -0,0 +1,596 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Driver.h"
+#include "Rider.h"
+#include "StandardRide.h"
+#include "DispatchService.h"
+#include "DriverLeaderboard.h"
+#include "RideJournal.h"
+#include "RideColumns.h"
+#include "RideAnalytics.h"
+#include "BatchMatcher.h"
+#include "RideRegistry.h"
+#include "SurgeEngine.h"
+#include "RoadNetwork.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <unistd.h>
+#endif
+
+// Self-checks for the concurrent and persistent parts of the ride subsystem.
+// The journal, column and routing checks write (and remove) a ride_selftest_journal
+// directory, a ride_selftest.cols file and a ride_selftest.graph file.
+// Usage: ride_selftest [burstRequests]
+// Each check prints PASS or FAIL; the exit code is 1 if any check failed.
+// Build with -fsanitize=thread (GCC/Clang) to run the dispatch burst under ThreadSanitizer.
+
+static int failures = 0;
+
+static void check(bool ok, const std::string& what) {
+    std::cout << (ok ? "PASS  " : "FAIL  ") << what << std::endl;
+    if (!ok) {
+        ++failures;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Dispatch: a burst of requests through every shard, with cross-shard riders
+
+static void checkDispatchBurst(int shardCount, std::size_t requests, std::size_t queueCapacity) {
+    const int DRIVERS = 256;
+    const int RIDERS = 1000;
+    const int ZONES = 64;
+
+    std::vector<Driver> drivers;
+    std::vector<Rider> riders;
+    drivers.reserve(DRIVERS);
+    riders.reserve(RIDERS);
+    for (int i = 0; i < DRIVERS; ++i) {
+        drivers.push_back(Driver(i + 1, "Driver"));
+    }
+    for (int i = 0; i < RIDERS; ++i) {
+        riders.push_back(Rider(i + 1, "Rider"));
+    }
+    LocationID pickup = LocationTable::global().intern("Self-test pickup");
+    LocationID dropoff = LocationTable::global().intern("Self-test dropoff");
+
+    DispatchConfig config;
+    config.shardCount = shardCount;
+    config.queueCapacity = queueCapacity;
+    config.autoReleaseDrivers = true;
+    DispatchService service(config);
+    for (int i = 0; i < DRIVERS; ++i) {
+        service.addDriver(drivers[i], i % ZONES);
+    }
+    for (int i = 0; i < RIDERS; ++i) {
+        service.addRider(riders[i], (i * 7) % ZONES); // Mostly homed away from their request zone
+    }
+    service.start();
+
+    std::size_t accepted = 0;
+    for (std::size_t i = 0; i < requests; ++i) {
+        DispatchRequest request;
+        request.riderID = static_cast<int>(i % RIDERS) + 1;
+        request.zone = static_cast<int>(i % ZONES);
+        request.type = i % 5 == 0 ? RideType::Premium : RideType::Standard;
+        request.pickup = pickup;
+        request.dropoff = dropoff;
+        request.distance = 1.0 + static_cast<double>(i % 20);
+        request.requestTime = 0;
+        while (!service.submit(request)) {
+            std::this_thread::yield(); // Queue full: let the workers catch up
+        }
+        ++accepted;
+
+        // Releasing an auto-released (idle) driver must be ignored, not double-queue them
+        if (i % 1000 == 0) {
+            service.releaseDriver(static_cast<int>(i % DRIVERS) + 1);
+        }
+    }
+    service.waitUntilDrained();
+    bool releasedWhileRunning = service.releaseDriver(1);
+    service.stop();
+    DispatchStats stats = service.getStats();
+
+    // Every ride lands exactly once with a driver and once with its rider, with a unique id
+    std::size_t driverRides = 0, riderRides = 0;
+    double earnings = 0.0, spending = 0.0;
+    std::vector<int> rideIDs;
+    rideIDs.reserve(accepted);
+    for (int i = 0; i < DRIVERS; ++i) {
+        driverRides += drivers[i].getTotalRides();
+        earnings += drivers[i].calculateTotalEarnings();
+        drivers[i].forEachAssignedRide([&](const Ride& ride) { rideIDs.push_back(ride.getRideID()); });
+    }
+    for (int i = 0; i < RIDERS; ++i) {
+        riderRides += riders[i].getTotalRides();
+        spending += riders[i].calculateTotalSpending();
+    }
+    std::sort(rideIDs.begin(), rideIDs.end());
+
+    std::ostringstream name;
+    name << "dispatch burst: " << requests << " requests, " << shardCount << " shard(s), queue " << queueCapacity;
+    check(stats.dispatched == accepted && driverRides == accepted && riderRides == accepted
+              && std::adjacent_find(rideIDs.begin(), rideIDs.end()) == rideIDs.end()
+              && std::fabs(earnings - spending) <= 1e-9 * earnings
+              && releasedWhileRunning && !service.releaseDriver(1),
+          name.str());
+    // The service (and the rides in its pools) is destroyed here, before the histories are dropped
+}
+
+// ---------------------------------------------------------------------------
+// Journal: a crash that tears the last dictionary entry must not lose later entries
+
+static void removeJournal(const std::string& directory) {
+    for (unsigned index = 1;; ++index) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/rides-%06u.seg", index);
+        if (std::remove((directory + name).c_str()) != 0) {
+            break;
+        }
+    }
+    std::remove((directory + "/locations.dict").c_str());
+#ifdef _WIN32
+    _rmdir(directory.c_str());
+#else
+    rmdir(directory.c_str());
+#endif
+}
+
+static void appendBytes(const std::string& path, const void* data, std::size_t size) {
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+    if (file != nullptr) {
+        std::fwrite(data, 1, size, file);
+        std::fclose(file);
+    }
+}
+
+static void checkJournalRecovery() {
+    const std::string directory = "ride_selftest_journal";
+    removeJournal(directory);
+    {
+        RideJournalWriter writer(directory, 64 * 1024, 1);
+        writer.append(StandardRide(1, "Journal A", "Journal B", 3.0), 1, 1);
+    }
+
+    // Crash mid-append: the header of entry 2 made it to disk, its name did not
+    const std::uint32_t torn[2] = { 2, 40 };
+    appendBytes(directory + "/locations.dict", torn, sizeof(torn));
+    appendBytes(directory + "/locations.dict", "Jou", 3);
+    {
+        RideJournalWriter writer(directory, 10, 1); // Less than two records: one record per segment
+        writer.append(StandardRide(2, "Journal C", "Journal A", 4.0), 2, 2);
+        writer.append(StandardRide(3, "Journal D", "Journal C", 5.0), 3, 3);
+    }
+
+    // A corrupt length must be rejected, not allocated
+    const std::uint32_t corrupt[2] = { 4, 0xFFFFFFF0u };
+    appendBytes(directory + "/locations.dict", corrupt, sizeof(corrupt));
+
+    RideJournalReader reader(directory);
+    std::vector<std::string> names;
+    LocationTable& table = LocationTable::global();
+    reader.forEach([&](const TripRecord& record) {
+        names.push_back(table.name(reader.resolveLocation(record.pickup)));
+        names.push_back(table.name(reader.resolveLocation(record.dropoff)));
+    });
+    const char* expected[] = { "Journal A", "Journal B", "Journal C", "Journal A", "Journal D", "Journal C" };
+    check(names == std::vector<std::string>(expected, expected + 6) && reader.getSegmentCount() == 3,
+          "journal: entries written after a torn dictionary entry read back");
+    removeJournal(directory);
+}
+
+// ---------------------------------------------------------------------------
+// Columns: rides read back exactly; a trailer whose offsets wrap 64-bit arithmetic is rejected
+
+static void checkColumnRoundTrip() {
+    const std::string path = "ride_selftest.cols";
+    const int RIDES = 1000;
+    const char* places[] = { "Column A", "Column B", "Column C" };
+    {
+        RideColumnWriter writer(path, 64); // Many row groups, the last one partial
+        for (int i = 0; i < RIDES; ++i) {
+            writer.append(StandardRide(i + 1, places[i % 3], places[(i + 1) % 3], 1.0 + i % 9));
+        }
+    }
+
+    bool exact = false;
+    {
+        RideColumnReader reader(path);
+        exact = reader.isOpen() && reader.getRowCount() == static_cast<std::uint64_t>(RIDES)
+                && reader.getLocationCount() == 3 && reader.resolveLocation(3) == INVALID_LOCATION;
+        LocationTable& table = LocationTable::global();
+        int row = 0;
+        for (std::size_t g = 0; exact && g < reader.getRowGroupCount(); ++g) {
+            const std::int32_t* ids = reader.getRideIDs(g);
+            const std::uint32_t* pickups = reader.getPickups(g);
+            const std::uint32_t* dropoffs = reader.getDropoffs(g);
+            const double* distances = reader.getDistances(g);
+            const double* fares = reader.getFares(g);
+            for (std::size_t r = 0; exact && r < reader.getRowGroupSize(g); ++r, ++row) {
+                StandardRide ride(row + 1, places[row % 3], places[(row + 1) % 3], 1.0 + row % 9);
+                exact = ids[r] == row + 1 && table.name(reader.resolveLocation(pickups[r])) == places[row % 3]
+                        && table.name(reader.resolveLocation(dropoffs[r])) == places[(row + 1) % 3]
+                        && distances[r] == ride.getDistance() && fares[r] == ride.fare();
+            }
+        }
+        exact = exact && row == RIDES;
+    }
+
+    // Corrupt the trailer so dictionaryOffset + dictionary size wraps to a small value
+    std::vector<char> bytes;
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file != nullptr) {
+        char buffer[4096];
+        std::size_t got;
+        while ((got = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+            bytes.insert(bytes.end(), buffer, buffer + got);
+        }
+        std::fclose(file);
+    }
+    bool rejected = false;
+    if (bytes.size() >= sizeof(ColumnFileTrailer)) {
+        ColumnFileTrailer trailer;
+        std::memcpy(&trailer, &bytes[bytes.size() - sizeof(trailer)], sizeof(trailer));
+        trailer.dictionaryOffset = 0 - (std::uint64_t(trailer.locationCount) + 1) * sizeof(std::uint32_t);
+        std::memcpy(&bytes[bytes.size() - sizeof(trailer)], &trailer, sizeof(trailer));
+        file = std::fopen(path.c_str(), "wb");
+        if (file != nullptr) {
+            std::fwrite(&bytes[0], 1, bytes.size(), file);
+            std::fclose(file);
+        }
+        RideColumnReader reader(path);
+        rejected = !reader.isOpen();
+    }
+    std::remove(path.c_str());
+    check(exact && rejected, "columns: rides round-trip; a wrapping dictionary offset is rejected");
+}
+
+// ---------------------------------------------------------------------------
+// Analytics: the key that marks free hash slots is a legal TimeBucket key (-1)
+
+static void checkAnalyticsEmptyKey() {
+    const int BUCKETS = 1000;
+    std::vector<TripRecord> records;
+    for (int b = -1; b < BUCKETS - 1; ++b) {
+        for (int r = 0; r <= (b + 1) % 3; ++r) {
+            TripRecord record = TripRecord();
+            record.requestTime = static_cast<std::int64_t>(b) * 60;
+            record.fare = 10.0;
+            record.distance = 2.0;
+            records.push_back(record);
+        }
+    }
+    RideAnalytics::Query query(RideAnalytics::GroupBy::TimeBucket);
+    query.bucketSeconds = 60;
+    query.threads = 1;
+    std::vector<GroupStats> groups = RideAnalytics::aggregate(records, query);
+
+    bool counted = groups.size() == static_cast<std::size_t>(BUCKETS);
+    std::uint64_t total = 0;
+    for (std::size_t g = 0; g < groups.size(); ++g) {
+        int bucket = static_cast<int>(static_cast<std::int64_t>(groups[g].key));
+        counted = counted && groups[g].count == static_cast<std::uint64_t>((bucket + 1) % 3 + 1);
+        total += groups[g].count;
+    }
+    check(counted && total == records.size(), "analytics: a TimeBucket of -1 is its own group");
+}
+
+// ---------------------------------------------------------------------------
+// Matching: a chain where serving everyone means moving every request off its nearest driver
+
+static void checkMatchingChain() {
+    const double requestX[] = { -2.9, 0.0, 2.9, 5.8 };
+    const double driverX[] = { 0.0, 2.9, 5.8, 8.7 };
+    std::vector<MatchRequest> requests;
+    std::vector<MatchDriver> drivers;
+    for (int i = 0; i < 4; ++i) {
+        MatchRequest request;
+        request.requestID = i + 1;
+        request.pickup.x = requestX[i];
+        request.pickup.y = 0.0;
+        requests.push_back(request);
+        MatchDriver driver;
+        driver.driverID = i + 1;
+        driver.position.x = driverX[i];
+        driver.position.y = 0.0;
+        drivers.push_back(driver);
+    }
+    MatchConfig config;
+    config.searchRadius = 3.0;
+    MatchResult result = BatchMatcher(config).solve(requests, drivers);
+    check(result.assignments.size() == 4 && result.unmatchedRequests.empty()
+              && std::fabs(result.totalPickupMiles - 4 * 2.9) < 1e-9,
+          "matching: every request of a long chain is served");
+}
+
+// ---------------------------------------------------------------------------
+// Routing: the contraction hierarchy agrees with plain Dijkstra on a generated grid
+
+struct TestRoad {
+    int from;
+    int to;
+    double miles;
+    double minutes;
+};
+
+// Fastest (minutes, miles) from source to every vertex; infinite minutes if unreachable
+static void dijkstra(int vertices, const std::vector<TestRoad>& arcs, int source,
+                     std::vector<double>& minutes, std::vector<double>& miles) {
+    typedef std::pair<double, int> Entry;
+    minutes.assign(vertices, std::numeric_limits<double>::infinity());
+    miles.assign(vertices, 0.0);
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+    minutes[source] = 0.0;
+    queue.push(Entry(0.0, source));
+    while (!queue.empty()) {
+        Entry top = queue.top();
+        queue.pop();
+        if (top.first > minutes[top.second]) {
+            continue;
+        }
+        for (std::size_t a = 0; a < arcs.size(); ++a) {
+            if (arcs[a].from == top.second && top.first + arcs[a].minutes < minutes[arcs[a].to]) {
+                minutes[arcs[a].to] = top.first + arcs[a].minutes;
+                miles[arcs[a].to] = miles[top.second] + arcs[a].miles;
+                queue.push(Entry(minutes[arcs[a].to], arcs[a].to));
+            }
+        }
+    }
+}
+
+static bool sameLeg(const RouteLeg& leg, double minutes, double miles) {
+    if (minutes == std::numeric_limits<double>::infinity()) {
+        return !leg.reachable();
+    }
+    return leg.reachable() && std::fabs(leg.minutes - minutes) <= 1e-4 * (1.0 + minutes)
+           && std::fabs(leg.miles - miles) <= 1e-4 * (1.0 + miles);
+}
+
+static void checkRoutingGrid() {
+    const int SIDE = 12;
+    const int VERTICES = SIDE * SIDE + 1; // The last vertex is an island with one road out
+    const std::string path = "ride_selftest.graph";
+
+    // Two-way streets along the grid, one-way diagonals, random lengths and speeds
+    std::vector<TestRoad> arcs;
+    unsigned state = 12345;
+    for (int v = 0; v < SIDE * SIDE; ++v) {
+        int row = v / SIDE, column = v % SIDE;
+        for (int kind = 0; kind < 3; ++kind) {
+            int next = kind == 0 ? (column + 1 < SIDE ? v + 1 : -1)
+                     : kind == 1 ? (row + 1 < SIDE ? v + SIDE : -1)
+                                 : (row + 1 < SIDE && column + 1 < SIDE && v % 3 == 0 ? v + SIDE + 1 : -1);
+            if (next < 0) {
+                continue;
+            }
+            state = state * 1103515245u + 12345u;
+            double miles = 0.5 + (state >> 16) % 2000 / 1000.0;
+            state = state * 1103515245u + 12345u;
+            TestRoad road = { v, next, miles, miles * (1.0 + (state >> 16) % 3000 / 1000.0) };
+            arcs.push_back(road);
+            if (kind < 2) {
+                TestRoad back = { next, v, road.miles, road.minutes };
+                arcs.push_back(back);
+            }
+        }
+    }
+    TestRoad bridge = { VERTICES - 1, 0, 1.0, 2.0 };
+    arcs.push_back(bridge);
+
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        check(false, "routing: route() and table() match Dijkstra on a grid");
+        return;
+    }
+    for (int v = 0; v < VERTICES; ++v) {
+        std::fprintf(file, "v %d Grid %d\n", v, v);
+    }
+    for (std::size_t a = 0; a < arcs.size(); ++a) {
+        std::fprintf(file, "a %d %d %.17g %.17g\n", arcs[a].from, arcs[a].to, arcs[a].miles, arcs[a].minutes);
+    }
+    std::fclose(file);
+
+    RoadNetwork network;
+    bool loaded = network.load(path);
+    std::remove(path.c_str());
+    RouteQuery query(network);
+
+    std::vector<LocationID> locations;
+    for (int v = 0; v < VERTICES; ++v) {
+        std::ostringstream name;
+        name << "Grid " << v;
+        locations.push_back(LocationTable::global().intern(name.str()));
+    }
+    std::vector<RouteLeg> legs;
+    query.table(locations, locations, legs);
+
+    bool matches = loaded && network.getNodeCount() == static_cast<std::size_t>(VERTICES);
+    std::vector<double> minutes, miles;
+    for (int s = 0; matches && s < VERTICES; ++s) {
+        dijkstra(VERTICES, arcs, s, minutes, miles);
+        for (int t = 0; matches && t < VERTICES; ++t) {
+            RouteLeg leg;
+            matches = query.route(locations[s], locations[t], leg) && sameLeg(leg, minutes[t], miles[t])
+                      && sameLeg(legs[s * VERTICES + t], minutes[t], miles[t]);
+        }
+    }
+
+    // Distance is set before the ride is recorded and left alone afterwards
+    Driver driver(1, "Routing driver");
+    std::shared_ptr<Ride> ride = std::make_shared<StandardRide>(1, locations[0], locations[SIDE * SIDE - 1], 1.0);
+    dijkstra(VERTICES, arcs, 0, minutes, miles);
+    bool assigned = query.assignDistance(*ride) && std::fabs(ride->getDistance() - miles[SIDE * SIDE - 1]) < 1e-3;
+    driver.recordRide(ride);
+    double recorded = ride->getDistance();
+    std::shared_ptr<Ride> island = std::make_shared<StandardRide>(2, locations[0], locations[VERTICES - 1], 1.0);
+    assigned = assigned && !query.assignDistance(*ride) && ride->getDistance() == recorded
+               && !query.assignDistance(*island) && island->getDistance() == 1.0;
+    check(matches && assigned, "routing: route() and table() match Dijkstra on a grid; recorded rides keep their distance");
+}
+
+// ---------------------------------------------------------------------------
+// Registry: cancelling and reassigning rides keeps both histories and totals exact
+
+static void checkRegistryRemoval() {
+    const int RIDES = 20000;
+    Driver first(1, "Registry driver 1");
+    Driver second(2, "Registry driver 2");
+    Rider rider(1, "Registry rider");
+    RideRegistry registry;
+    std::vector<RideHandle> handles;
+    for (int i = 0; i < RIDES; ++i) {
+        std::shared_ptr<Ride> ride = std::make_shared<StandardRide>(i + 1, "Registry A", "Registry B", 1.0 + i % 7);
+        first.recordRide(ride);
+        rider.recordRequest(ride);
+        handles.push_back(registry.add(ride, &first, &rider));
+    }
+    // Cancel every third ride and move every third of the rest, from the oldest on
+    double kept = 0.0, moved = 0.0;
+    for (int i = 0; i < RIDES; ++i) {
+        if (i % 3 == 0) {
+            registry.cancel(handles[i]);
+        } else {
+            double fare = registry.get(handles[i])->fare();
+            kept += fare;
+            if (i % 3 == 1) {
+                registry.reassign(handles[i], second);
+                moved += fare;
+            }
+        }
+    }
+
+    bool consistent = registry.size() == static_cast<std::size_t>(RIDES - (RIDES + 2) / 3);
+    std::vector<int> ids;
+    first.forEachAssignedRide([&](const Ride& ride) { ids.push_back(ride.getRideID()); });
+    second.forEachAssignedRide([&](const Ride& ride) { ids.push_back(ride.getRideID()); });
+    std::sort(ids.begin(), ids.end());
+    for (std::size_t k = 0; k < ids.size(); ++k) {
+        consistent = consistent && (ids[k] - 1) % 3 != 0;
+    }
+    std::vector<int> riderIDs;
+    rider.forEachRequestedRide([&](const Ride& ride) { riderIDs.push_back(ride.getRideID()); });
+    std::sort(riderIDs.begin(), riderIDs.end());
+    check(consistent && ids.size() == registry.size() && riderIDs == ids
+              && std::fabs(first.calculateTotalEarnings() + second.calculateTotalEarnings() - kept) < 1e-6
+              && std::fabs(second.calculateTotalEarnings() - moved) < 1e-6
+              && std::fabs(rider.calculateTotalSpending() - kept) < 1e-6,
+          "registry: cancel and reassign keep histories and totals exact");
+}
+
+// ---------------------------------------------------------------------------
+// Leaderboard: drivers move, copy and die while tracked; rides are recorded concurrently
+
+static void checkLeaderboardTracking() {
+    const int DRIVERS = 64;
+    const int THREADS = 4;
+    const int RIDES_PER_DRIVER = 200;
+
+    DriverLeaderboard board;
+    std::vector<Driver> drivers;
+    for (int i = 0; i < DRIVERS; ++i) {
+        drivers.push_back(Driver(i + 1, "Ranked"));
+        board.track(drivers.back()); // Later push_backs move the tracked drivers
+    }
+    {
+        Driver copy = drivers[0];
+        Driver doomed(DRIVERS + 1, "Doomed");
+        board.track(doomed);
+    } // The copy must not untrack driver 1; the doomed driver must untrack itself
+    bool tracking = board.size() == static_cast<std::size_t>(DRIVERS) && board.rankOf(DriverLeaderboard::Metric::Earnings, 1) != 0
+                    && board.rankOf(DriverLeaderboard::Metric::Earnings, DRIVERS + 1) == 0;
+
+    // Driver i earns i rides' worth, recorded from several threads at once
+    std::vector<std::shared_ptr<Ride>> rides;
+    for (int i = 0; i < DRIVERS * RIDES_PER_DRIVER; ++i) {
+        rides.push_back(std::make_shared<StandardRide>(i + 1, "Ranked A", "Ranked B", 1.0 + (i % DRIVERS)));
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.push_back(std::thread([&, t]() {
+            for (int d = t; d < DRIVERS; d += THREADS) {
+                for (int r = 0; r < RIDES_PER_DRIVER; ++r) {
+                    drivers[d].recordRide(rides[r * DRIVERS + d]);
+                }
+            }
+        }));
+    }
+    for (std::size_t t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    std::vector<LeaderboardEntry> top = board.topK(DriverLeaderboard::Metric::Earnings, 3);
+    check(tracking && top.size() == 3 && top[0].driverID == DRIVERS && top[1].driverID == DRIVERS - 1
+              && top[2].driverID == DRIVERS - 2 && board.rankOf(DriverLeaderboard::Metric::Earnings, 1) == DRIVERS
+              && std::fabs(top[0].score - drivers[DRIVERS - 1].calculateTotalEarnings()) < 1e-9,
+          "leaderboard: tracking survives moves and copies; concurrent rides rank correctly");
+}
+
+// ---------------------------------------------------------------------------
+// Surge: earnings and spending must agree with fare() however late surge is applied
+
+static void checkSurgeBeforeRecording() {
+    SurgeEngine surge(1);
+    surge.setAvailableDrivers(0, 1);
+    for (int i = 0; i < 100; ++i) {
+        surge.recordRequest(0, 1000);
+    }
+    Driver driver(1, "Surge driver");
+    Rider rider(1, "Surge rider");
+    std::shared_ptr<Ride> priced = std::make_shared<StandardRide>(1, "Surge A", "Surge B", 10.0);
+    std::shared_ptr<Ride> late = std::make_shared<StandardRide>(2, "Surge B", "Surge A", 10.0);
+    surge.priceRide(*priced, 0, 1000);
+    driver.recordRide(priced);
+    rider.recordRequest(priced);
+    driver.recordRide(late);
+    rider.recordRequest(late);
+    surge.priceRide(*late, 0, 1000); // Too late: the ride keeps the price it was recorded at
+
+    double fares = priced->fare() + late->fare();
+    check(priced->getSurgeMultiplier() > 1.0 && late->getSurgeMultiplier() == 1.0
+              && std::fabs(driver.calculateTotalEarnings() - fares) <= 1e-9 * fares
+              && std::fabs(rider.calculateTotalSpending() - fares) <= 1e-9 * fares,
+          "surge: fare totals match fare() when a recorded ride is repriced");
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t burst = argc > 1 ? static_cast<std::size_t>(std::atof(argv[1])) : 2000000;
+    if (burst < 1) {
+        std::cout << "burstRequests must be positive" << std::endl;
+        return 1;
+    }
+
+    std::cout << "=== Ride Subsystem Self-Test ===" << std::endl;
+
+    const int shardCounts[] = { 1, 2, 4, 8 };
+    for (std::size_t i = 0; i < sizeof(shardCounts) / sizeof(shardCounts[0]); ++i) {
+        checkDispatchBurst(shardCounts[i], burst, 1 << 16);
+    }
+    // Tiny queues: mailboxes overflow constantly, which used to deadlock two workers
+    checkDispatchBurst(4, std::min<std::size_t>(burst, 200000), 4);
+    checkJournalRecovery();
+    checkColumnRoundTrip();
+    checkAnalyticsEmptyKey();
+    checkMatchingChain();
+    checkRoutingGrid();
+    checkRegistryRemoval();
+    checkLeaderboardTracking();
+    checkSurgeBeforeRecording();
+
+    std::cout << (failures == 0 ? "All checks passed" : "SOME CHECKS FAILED") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+#ifndef RIDEVIEW_H
+#define RIDEVIEW_H
+
+#include <cstddef>
+#include <ctime>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "Ride.h"
+
+// Criteria for walking a ride history without copying it.
+// A default constructed filter matches every ride; the builder methods narrow it down.
+struct RideFilter {
+    unsigned typeMask;   // One bit per RideType
+    double minDistance;  // Inclusive
+    double maxDistance;  // Inclusive
+    std::time_t from;    // Inclusive request time range
+    std::time_t to;
+
+    RideFilter()
+        : typeMask(~0u), minDistance(0.0), maxDistance(std::numeric_limits<double>::max()),
+          from(std::numeric_limits<std::time_t>::min()), to(std::numeric_limits<std::time_t>::max()) {
+    }
+
+    RideFilter& ofType(RideType type) {
+        typeMask = 1u << static_cast<unsigned>(type);
+        return *this;
+    }
+
+    RideFilter& distanceBetween(double minDist, double maxDist) {
+        minDistance = minDist;
+        maxDistance = maxDist;
+        return *this;
+    }
+
+    RideFilter& requestedBetween(std::time_t start, std::time_t end) {
+        from = start;
+        to = end;
+        return *this;
+    }
+
+    bool matches(const Ride& ride) const {
+        return (typeMask & (1u << static_cast<unsigned>(ride.getRideType()))) != 0
+            && ride.getDistance() >= minDistance && ride.getDistance() <= maxDistance
+            && ride.getRequestTime() >= from && ride.getRequestTime() <= to;
+    }
+};
+
+// Read-only view over a ride history. Iterating yields const Ride& and never copies
+// the underlying vector or touches shared_ptr reference counts.
+// The view is invalidated when rides are added to the owning Driver/Rider.
+class RideRange {
+public:
+    typedef std::vector<std::shared_ptr<Ride>>::const_iterator BaseIterator;
+
+    class iterator {
+    private:
+        BaseIterator current;
+
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef const Ride value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Ride* pointer;
+        typedef const Ride& reference;
+
+        iterator() {}
+        explicit iterator(BaseIterator it) : current(it) {}
+
+        reference operator*() const { return **current; }
+        pointer operator->() const { return current->get(); }
+        reference operator[](difference_type n) const { return *current[n]; }
+        iterator& operator++() { ++current; return *this; }
+        iterator operator++(int) { iterator old(*this); ++current; return old; }
+        iterator& operator--() { --current; return *this; }
+        iterator operator--(int) { iterator old(*this); --current; return old; }
+        iterator& operator+=(difference_type n) { current += n; return *this; }
+        iterator& operator-=(difference_type n) { current -= n; return *this; }
+        iterator operator+(difference_type n) const { return iterator(current + n); }
+        iterator operator-(difference_type n) const { return iterator(current - n); }
+        difference_type operator-(const iterator& other) const { return current - other.current; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+        bool operator<(const iterator& other) const { return current < other.current; }
+    };
+
+private:
+    BaseIterator first;
+    BaseIterator last;
+
+public:
+    RideRange(BaseIterator begin, BaseIterator end) : first(begin), last(end) {}
+
+    iterator begin() const { return iterator(first); }
+    iterator end() const { return iterator(last); }
+    std::size_t size() const { return static_cast<std::size_t>(last - first); }
+    bool empty() const { return first == last; }
+    const Ride& operator[](std::size_t index) const { return *first[index]; }
+};
+
+// View that only yields rides accepted by a RideFilter
+class FilteredRideRange {
+public:
+    typedef RideRange::BaseIterator BaseIterator;
+
+    class iterator {
+    private:
+        BaseIterator current;
+        BaseIterator last;
+        const RideFilter* filter;
+
+        void skipRejected() {
+            while (current != last && !filter->matches(**current)) {
+                ++current;
+            }
+        }
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef const Ride value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Ride* pointer;
+        typedef const Ride& reference;
+
+        iterator() : filter(nullptr) {}
+        iterator(BaseIterator it, BaseIterator end, const RideFilter* rideFilter)
+            : current(it), last(end), filter(rideFilter) {
+            skipRejected();
+        }
+
+        reference operator*() const { return **current; }
+        pointer operator->() const { return current->get(); }
+        iterator& operator++() { ++current; skipRejected(); return *this; }
+        iterator operator++(int) { iterator old(*this); ++*this; return old; }
+        bool operator==(const iterator& other) const { return current == other.current; }
+        bool operator!=(const iterator& other) const { return current != other.current; }
+    };
+
+private:
+    BaseIterator first;
+    BaseIterator last;
+    RideFilter filter; // Held by value so the view can outlive the caller's filter
+
+public:
+    FilteredRideRange(BaseIterator begin, BaseIterator end, const RideFilter& rideFilter)
+        : first(begin), last(end), filter(rideFilter) {
+    }
+
+    iterator begin() const { return iterator(first, last, &filter); }
+    iterator end() const { return iterator(last, last, &filter); }
+};
+
+#endif // RIDEVIEW_H
@@ -6,41 +6,78 @@ Rider::Rider(int id, const std::string& riderName)
 
 void Rider::requestRide(std::shared_ptr<Ride> ride) {
     if (ride) {
-        requestedRides.push_back(ride);
+        recordRequest(ride);
         std::cout << "Ride " << ride->getRideID() << " requested by rider " << name << std::endl;
     }
 }
 
-void Rider::viewRides() const {
-    std::cout << "\n=== Ride History for " << name << " ===" << std::endl;
+void Rider::recordRequest(std::shared_ptr<Ride> ride) {
+    if (ride) {
+        ride->setRiderIndex(static_cast<std::uint32_t>(requestedRides.size()));
+        requestedRides.push_back(ride);
+        ride->markFareRecorded();
+        spending.addFare(ride->getRideType(), ride->fare());
+    }
+}
+
+void Rider::replayRequest(RideType type, double fare) {
+    spending.addFare(type, fare);
+}
+
+std::shared_ptr<Ride> Rider::removeRequestAt(size_t index) {
+    // Swap with the last ride and pop, so removal never shifts the history
+    std::shared_ptr<Ride> ride = requestedRides[index];
+    if (index + 1 != requestedRides.size()) {
+        requestedRides[index] = requestedRides.back();
+        requestedRides[index]->setRiderIndex(static_cast<std::uint32_t>(index));
+    }
+    requestedRides.pop_back();
+    spending.removeFare(ride->getRideType(), ride->fare());
+    if (spending.needsExtremesRebuild()) {
+        spending.rebuildExtremes(viewRequestedRides());
+    }
+    return ride;
+}
+
+std::shared_ptr<Ride> Rider::removeRequest(const Ride& ride) {
+    size_t index = ride.getRiderIndex();
+    if (index < requestedRides.size() && requestedRides[index].get() == &ride) {
+        return removeRequestAt(index);
+    }
+    return removeRequest(ride.getRideID()); // Recorded by more than one rider: its index is another's
+}
+
+std::shared_ptr<Ride> Rider::removeRequest(int rideID) {
+    for (size_t i = requestedRides.size(); i-- > 0;) {
+        if (requestedRides[i]->getRideID() == rideID) {
+            return removeRequestAt(i);
+        }
+    }
+    return std::shared_ptr<Ride>();
+}
+
+void Rider::viewRides(std::ostream& out) const {
+    out << "\n=== Ride History for " << name << " ===\n";
     if (requestedRides.empty()) {
-        std::cout << "No rides requested yet." << std::endl;
+        out << "No rides requested yet.\n";
     } else {
         for (size_t i = 0; i < requestedRides.size(); ++i) {
-            std::cout << "\nRide " << (i + 1) << ":" << std::endl;
-            requestedRides[i]->rideDetails();
+            out << "\nRide " << (i + 1) << ":\n";
+            requestedRides[i]->rideDetails(out);
         }
     }
-    std::cout << "===================================" << std::endl;
+    out << "===================================\n";
 }
 
 std::vector<std::shared_ptr<Ride>> Rider::getRequestedRides() const {
-    return requestedRides; // Returns a copy, maintaining encapsulation
+    return requestedRides; // Returns a copy; prefer viewRequestedRides() to avoid it
 }
 
 void Rider::getRiderInfo() const {
     std::cout << "\n=== Rider Information ===" << std::endl;
     std::cout << "Rider ID: " << riderID << std::endl;
     std::cout << "Name: " << name << std::endl;
-    std::cout << "Total Rides Requested: " << requestedRides.size() << std::endl;
+    std::cout << "Total Rides Requested: " << spending.getCount() << std::endl;
     std::cout << "Total Spending: $" << calculateTotalSpending() << std::endl;
     std::cout << "=========================" << std::endl;
-}
-
-double Rider::calculateTotalSpending() const {
-    double total = 0.0;
-    for (const auto& ride : requestedRides) {
-        total += ride->fare();
-    }
-    return total;
 }
\ No newline at end of file
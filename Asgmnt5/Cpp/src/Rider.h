@@ -6,12 +6,17 @@
 #include <memory>
 #include <iostream>
 #include "Ride.h"
+#include "RideView.h"
+#include "FareStats.h"
 
 class Rider {
 private:
     int riderID;
     std::string name;
     std::vector<std::shared_ptr<Ride>> requestedRides; // Encapsulated - private member
+    FareStats spending; // Running aggregates, updated on every requestRide
+
+    std::shared_ptr<Ride> removeRequestAt(size_t index);
 
 public:
     // Constructor
@@ -22,17 +27,39 @@ public:
     
     // Public methods to interact with private requestedRides (Encapsulation)
     void requestRide(std::shared_ptr<Ride> ride);
-    void viewRides() const;
+    void recordRequest(std::shared_ptr<Ride> ride); // Same as requestRide() without console output
+    void replayRequest(RideType type, double fare); // Restore aggregates from a persisted ride (e.g. RideJournal)
+    // Cancellation: drop from history and aggregates; null if absent. The last ride
+    // takes the removed one's place, so history order is not preserved. Removing the
+    // lowest or highest fare rebuilds the fare extremes from the history in O(n).
+    std::shared_ptr<Ride> removeRequest(const Ride& ride); // O(1) unless the extremes are rebuilt
+    std::shared_ptr<Ride> removeRequest(int rideID);       // Searches the history
+    void viewRides(std::ostream& out = std::cout) const;
     std::vector<std::shared_ptr<Ride>> getRequestedRides() const;
     void getRiderInfo() const;
     
+    // Non-copying access to the ride history
+    RideRange viewRequestedRides() const { return RideRange(requestedRides.begin(), requestedRides.end()); }
+    FilteredRideRange filterRequestedRides(const RideFilter& filter) const {
+        return FilteredRideRange(requestedRides.begin(), requestedRides.end(), filter);
+    }
+    
+    // Invoke callback(const Ride&) for every ride in the history
+    template <typename Callback>
+    void forEachRequestedRide(Callback callback) const {
+        for (size_t i = 0; i < requestedRides.size(); ++i) {
+            callback(*requestedRides[i]);
+        }
+    }
+    
     // Getter methods
     int getRiderID() const { return riderID; }
     std::string getName() const { return name; }
-    int getTotalRides() const { return requestedRides.size(); }
+    int getTotalRides() const { return spending.getCount(); } // Includes replayed rides
     
-    // Calculate total spending
-    double calculateTotalSpending() const;
+    // Total spending, kept up to date incrementally (O(1))
+    double calculateTotalSpending() const { return spending.getTotal(); }
+    const FareStats& getSpendingStats() const { return spending; }
 };
 
 #endif // RIDER_H
\ No newline at end of file
@@ -0,0 +1,554 @@
+#include "RoadNetwork.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <sstream>
+
+namespace {
+
+const float INFINITE_MINUTES = std::numeric_limits<float>::infinity();
+// Witness searches are bounded; a missed witness only costs a redundant shortcut.
+// Priorities are estimates, so they use a cheaper search than the real contraction.
+const int WITNESS_SETTLE_LIMIT = 500;
+const int ESTIMATE_SETTLE_LIMIT = 40;
+
+struct DynamicArc {
+    std::uint32_t node;
+    float minutes;
+    float miles;
+};
+
+// Adjacency of the graph while it is being contracted. Contracted vertices are
+// detached from their neighbors, so the lists only ever hold live vertices; a
+// contracted vertex keeps its own lists, which become its upward arcs.
+struct ContractionGraph {
+    std::vector<std::vector<DynamicArc> > out;
+    std::vector<std::vector<DynamicArc> > in;
+    std::vector<bool> contracted;
+    std::vector<int> contractedNeighbors;
+    std::vector<int> level;         // Hierarchy depth below a vertex
+
+    // Witness search workspace
+    typedef std::pair<float, std::uint32_t> Entry;
+    std::vector<float> distance;
+    std::vector<std::uint32_t> touched;
+    std::vector<Entry> heap;
+
+    explicit ContractionGraph(std::uint32_t nodeCount)
+        : out(nodeCount), in(nodeCount), contracted(nodeCount, false), contractedNeighbors(nodeCount, 0),
+          level(nodeCount, 0), distance(nodeCount, INFINITE_MINUTES) {
+    }
+
+    // Add or shorten the arc from -> to; returns true if the graph changed
+    bool addArc(std::uint32_t from, std::uint32_t to, float minutes, float miles) {
+        for (size_t i = 0; i < out[from].size(); ++i) {
+            if (out[from][i].node == to) {
+                if (minutes >= out[from][i].minutes) {
+                    return false;
+                }
+                out[from][i].minutes = minutes;
+                out[from][i].miles = miles;
+                for (size_t j = 0; j < in[to].size(); ++j) {
+                    if (in[to][j].node == from) {
+                        in[to][j].minutes = minutes;
+                        in[to][j].miles = miles;
+                    }
+                }
+                return true;
+            }
+        }
+        DynamicArc arc;
+        arc.node = to;
+        arc.minutes = minutes;
+        arc.miles = miles;
+        out[from].push_back(arc);
+        arc.node = from;
+        in[to].push_back(arc);
+        return true;
+    }
+
+    // Remove a freshly contracted vertex from its neighbors' lists
+    void detach(std::uint32_t node) {
+        for (size_t i = 0; i < out[node].size(); ++i) {
+            std::vector<DynamicArc>& arcs = in[out[node][i].node];
+            for (size_t j = 0; j < arcs.size(); ++j) {
+                if (arcs[j].node == node) {
+                    arcs[j] = arcs.back();
+                    arcs.pop_back();
+                    break;
+                }
+            }
+        }
+        for (size_t i = 0; i < in[node].size(); ++i) {
+            std::vector<DynamicArc>& arcs = out[in[node][i].node];
+            for (size_t j = 0; j < arcs.size(); ++j) {
+                if (arcs[j].node == node) {
+                    arcs[j] = arcs.back();
+                    arcs.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+
+    // Dijkstra from source that avoids 'skip', stopping past 'limit' minutes
+    void witnessSearch(std::uint32_t source, std::uint32_t skip, float limit, int settleLimit) {
+        for (size_t i = 0; i < touched.size(); ++i) {
+            distance[touched[i]] = INFINITE_MINUTES;
+        }
+        touched.clear();
+
+        heap.clear();
+        distance[source] = 0.0f;
+        touched.push_back(source);
+        heap.push_back(Entry(0.0f, source));
+
+        int settledCount = 0;
+        while (!heap.empty() && settledCount < settleLimit) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<Entry>());
+            Entry top = heap.back();
+            heap.pop_back();
+            if (top.first > distance[top.second]) {
+                continue;
+            }
+            if (top.first > limit) {
+                break;
+            }
+            ++settledCount;
+            const std::vector<DynamicArc>& arcs = out[top.second];
+            for (size_t i = 0; i < arcs.size(); ++i) {
+                std::uint32_t next = arcs[i].node;
+                if (next == skip) {
+                    continue;
+                }
+                float candidate = top.first + arcs[i].minutes;
+                if (candidate < distance[next]) {
+                    if (distance[next] == INFINITE_MINUTES) {
+                        touched.push_back(next);
+                    }
+                    distance[next] = candidate;
+                    heap.push_back(Entry(candidate, next));
+                    std::push_heap(heap.begin(), heap.end(), std::greater<Entry>());
+                }
+            }
+        }
+    }
+
+    // Shortcuts needed to contract node; applied only if 'apply' is set
+    int shortcutsFor(std::uint32_t node, bool apply) {
+        int shortcuts = 0;
+        for (size_t i = 0; i < in[node].size(); ++i) {
+            const DynamicArc& incoming = in[node][i];
+            float limit = 0.0f;
+            for (size_t j = 0; j < out[node].size(); ++j) {
+                if (out[node][j].node != incoming.node) {
+                    limit = std::max(limit, incoming.minutes + out[node][j].minutes);
+                }
+            }
+            witnessSearch(incoming.node, node, limit, apply ? WITNESS_SETTLE_LIMIT : ESTIMATE_SETTLE_LIMIT);
+
+            for (size_t j = 0; j < out[node].size(); ++j) {
+                DynamicArc outgoing = out[node][j];
+                if (outgoing.node == incoming.node) {
+                    continue;
+                }
+                float through = incoming.minutes + outgoing.minutes;
+                if (distance[outgoing.node] <= through) {
+                    continue; // A path avoiding node is at least as fast
+                }
+                ++shortcuts;
+                if (apply) {
+                    addArc(incoming.node, outgoing.node, through, incoming.miles + outgoing.miles);
+                }
+            }
+        }
+        return shortcuts;
+    }
+
+    int priority(std::uint32_t node) {
+        int degree = static_cast<int>(in[node].size() + out[node].size());
+        // Edge difference, plus terms that spread contraction evenly and keep the hierarchy shallow
+        return 2 * (shortcutsFor(node, false) - degree) + contractedNeighbors[node] + level[node];
+    }
+};
+
+bool parseFailure(const std::string& path, int lineNumber, const char* reason) {
+    std::cout << "Road graph " << path << ", line " << lineNumber << ": " << reason << std::endl;
+    return false;
+}
+
+} // namespace
+
+RoadNetwork::RoadNetwork() : roadCount(0), shortcutCount(0) {
+}
+
+bool RoadNetwork::load(const std::string& path) {
+    std::ifstream in(path.c_str());
+    if (!in) {
+        std::cout << "Cannot open road graph: " << path << std::endl;
+        return false;
+    }
+
+    std::unordered_map<long long, std::uint32_t> vertexOf; // File id -> vertex
+    std::unordered_map<LocationID, std::uint32_t> locations;
+    std::vector<std::pair<std::uint32_t, Arc> > arcs;
+    std::size_t roads = 0;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        std::size_t comment = line.find('#');
+        if (comment != std::string::npos) {
+            line.erase(comment);
+        }
+        std::istringstream fields(line);
+        std::string kind;
+        if (!(fields >> kind)) {
+            continue;
+        }
+
+        if (kind == "v") {
+            long long id;
+            std::string name;
+            if (!(fields >> id) || !std::getline(fields >> std::ws, name) || name.empty()) {
+                return parseFailure(path, lineNumber, "expected: v <id> <name>");
+            }
+            name.erase(name.find_last_not_of(" \t\r") + 1);
+            std::uint32_t vertex = static_cast<std::uint32_t>(vertexOf.size());
+            if (!vertexOf.insert(std::make_pair(id, vertex)).second) {
+                return parseFailure(path, lineNumber, "duplicate vertex id");
+            }
+            if (!locations.insert(std::make_pair(LocationTable::global().intern(name), vertex)).second) {
+                return parseFailure(path, lineNumber, "duplicate location name");
+            }
+        } else if (kind == "e" || kind == "a") {
+            long long from, to;
+            double miles, minutes;
+            if (!(fields >> from >> to >> miles >> minutes) || miles < 0.0 || minutes < 0.0) {
+                return parseFailure(path, lineNumber, "expected: e|a <from> <to> <miles> <minutes>");
+            }
+            std::unordered_map<long long, std::uint32_t>::const_iterator tail = vertexOf.find(from);
+            std::unordered_map<long long, std::uint32_t>::const_iterator head = vertexOf.find(to);
+            if (tail == vertexOf.end() || head == vertexOf.end()) {
+                return parseFailure(path, lineNumber, "road references an unknown vertex");
+            }
+            Arc arc;
+            arc.head = head->second;
+            arc.minutes = static_cast<float>(minutes);
+            arc.miles = static_cast<float>(miles);
+            arcs.push_back(std::make_pair(tail->second, arc));
+            if (kind == "e") {
+                arc.head = tail->second;
+                arcs.push_back(std::make_pair(head->second, arc));
+            }
+            ++roads;
+        } else {
+            return parseFailure(path, lineNumber, "unknown record type");
+        }
+    }
+
+    nodeOf.swap(locations);
+    roadCount = roads;
+    contract(static_cast<std::uint32_t>(vertexOf.size()), arcs);
+    return true;
+}
+
+void RoadNetwork::contract(std::uint32_t nodeCount, const std::vector<std::pair<std::uint32_t, Arc> >& arcs) {
+    ContractionGraph graph(nodeCount);
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        if (arcs[i].first != arcs[i].second.head) {
+            graph.addArc(arcs[i].first, arcs[i].second.head, arcs[i].second.minutes, arcs[i].second.miles);
+        }
+    }
+    std::size_t originalArcs = 0;
+    for (std::uint32_t v = 0; v < nodeCount; ++v) {
+        originalArcs += graph.out[v].size();
+    }
+
+    // Contract in order of priority, re-evaluating lazily when a vertex is popped
+    typedef std::pair<int, std::uint32_t> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > queue;
+    std::vector<int> priority(nodeCount);
+    for (std::uint32_t v = 0; v < nodeCount; ++v) {
+        priority[v] = graph.priority(v);
+        queue.push(Entry(priority[v], v));
+    }
+
+    while (!queue.empty()) {
+        Entry top = queue.top();
+        queue.pop();
+        if (graph.contracted[top.second] || top.first != priority[top.second]) {
+            continue; // Superseded entry
+        }
+        int current = graph.priority(top.second);
+        if (!queue.empty() && current > queue.top().first) {
+            priority[top.second] = current;
+            queue.push(Entry(current, top.second));
+            continue;
+        }
+
+        std::uint32_t node = top.second;
+        graph.shortcutsFor(node, true);
+        graph.contracted[node] = true;
+        graph.detach(node);
+        // Neighbors' priorities changed the most; refresh them now rather than on pop
+        for (int d = 0; d < 2; ++d) {
+            const std::vector<DynamicArc>& arcs = d == 0 ? graph.out[node] : graph.in[node];
+            for (size_t i = 0; i < arcs.size(); ++i) {
+                std::uint32_t neighbor = arcs[i].node;
+                ++graph.contractedNeighbors[neighbor];
+                graph.level[neighbor] = std::max(graph.level[neighbor], graph.level[node] + 1);
+                priority[neighbor] = graph.priority(neighbor);
+                queue.push(Entry(priority[neighbor], neighbor));
+            }
+        }
+    }
+
+    // A contracted vertex keeps exactly the arcs to and from vertices contracted after
+    // it, i.e. the arcs of its upward searches
+    std::size_t totalArcs = 0;
+    upwardBegin.assign(1, 0);
+    downwardBegin.assign(1, 0);
+    upwardArcs.clear();
+    downwardArcs.clear();
+    for (std::uint32_t v = 0; v < nodeCount; ++v) {
+        for (int d = 0; d < 2; ++d) {
+            const std::vector<DynamicArc>& arcs = d == 0 ? graph.out[v] : graph.in[v];
+            std::vector<Arc>& stored = d == 0 ? upwardArcs : downwardArcs;
+            for (size_t i = 0; i < arcs.size(); ++i) {
+                Arc arc;
+                arc.head = arcs[i].node;
+                arc.minutes = arcs[i].minutes;
+                arc.miles = arcs[i].miles;
+                stored.push_back(arc);
+            }
+            totalArcs += arcs.size();
+        }
+        upwardBegin.push_back(static_cast<std::uint32_t>(upwardArcs.size()));
+        downwardBegin.push_back(static_cast<std::uint32_t>(downwardArcs.size()));
+    }
+    shortcutCount = totalArcs - originalArcs;
+}
+
+RouteQuery::RouteQuery(const RoadNetwork& roadNetwork) : network(roadNetwork), currentStamp(0) {
+    std::size_t nodeCount = network.upwardBegin.empty() ? 0 : network.upwardBegin.size() - 1;
+    for (int d = 0; d < 2; ++d) {
+        minutes[d].assign(nodeCount, INFINITE_MINUTES);
+        miles[d].assign(nodeCount, 0.0f);
+        stamp[d].assign(nodeCount, 0);
+    }
+}
+
+void RouteQuery::nextStamp() {
+    if (++currentStamp == 0) { // Wrapped around: clear for real once every 4 billion searches
+        for (int d = 0; d < 2; ++d) {
+            std::fill(stamp[d].begin(), stamp[d].end(), 0u);
+        }
+        currentStamp = 1;
+    }
+}
+
+bool RouteQuery::nodeFor(LocationID location, std::uint32_t& node) const {
+    std::unordered_map<LocationID, std::uint32_t>::const_iterator it = network.nodeOf.find(location);
+    if (it == network.nodeOf.end()) {
+        return false;
+    }
+    node = it->second;
+    return true;
+}
+
+// Stall-on-demand: a vertex reached faster through a higher neighbor (via an arc the
+// search cannot use) is not on a shortest upward path, so it need not be expanded
+bool RouteQuery::stalled(int direction, std::uint32_t node, float nodeMinutes) const {
+    const std::vector<std::uint32_t>& begin = direction == 0 ? network.downwardBegin : network.upwardBegin;
+    const std::vector<RoadNetwork::Arc>& arcs = direction == 0 ? network.downwardArcs : network.upwardArcs;
+    for (std::uint32_t i = begin[node]; i < begin[node + 1]; ++i) {
+        std::uint32_t higher = arcs[i].head;
+        if (stamp[direction][higher] == currentStamp && minutes[direction][higher] + arcs[i].minutes < nodeMinutes) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Complete upward Dijkstra; used by table(), where every settled vertex matters
+void RouteQuery::upwardSearch(int direction, std::uint32_t source, bool recordSettled) {
+    const std::vector<std::uint32_t>& begin = direction == 0 ? network.upwardBegin : network.downwardBegin;
+    const std::vector<RoadNetwork::Arc>& arcs = direction == 0 ? network.upwardArcs : network.downwardArcs;
+
+    nextStamp();
+    settled.clear();
+    std::vector<QueueEntry>& queue = queues[direction];
+    queue.clear();
+    stamp[direction][source] = currentStamp;
+    minutes[direction][source] = 0.0f;
+    miles[direction][source] = 0.0f;
+    queue.push_back(QueueEntry(0.0f, source));
+
+    while (!queue.empty()) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+        QueueEntry top = queue.back();
+        queue.pop_back();
+        std::uint32_t node = top.second;
+        if (top.first > minutes[direction][node]) {
+            continue;
+        }
+        if (recordSettled) {
+            settled.push_back(node);
+        }
+        for (std::uint32_t i = begin[node]; i < begin[node + 1]; ++i) {
+            std::uint32_t next = arcs[i].head;
+            float candidate = top.first + arcs[i].minutes;
+            if (stamp[direction][next] != currentStamp || candidate < minutes[direction][next]) {
+                stamp[direction][next] = currentStamp;
+                minutes[direction][next] = candidate;
+                miles[direction][next] = miles[direction][node] + arcs[i].miles;
+                queue.push_back(QueueEntry(candidate, next));
+                std::push_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+            }
+        }
+    }
+}
+
+bool RouteQuery::route(LocationID from, LocationID to, RouteLeg& leg) {
+    std::uint32_t source, target;
+    if (!nodeFor(from, source) || !nodeFor(to, target)) {
+        return false;
+    }
+
+    leg.minutes = std::numeric_limits<double>::infinity();
+    leg.miles = 0.0;
+    if (source == target) {
+        leg.minutes = 0.0;
+        return true;
+    }
+
+    // Alternate the forward and backward upward searches; each stops once its
+    // smallest key cannot improve the best meeting point
+    nextStamp();
+    std::uint32_t ends[2] = { source, target };
+    for (int d = 0; d < 2; ++d) {
+        stamp[d][ends[d]] = currentStamp;
+        minutes[d][ends[d]] = 0.0f;
+        miles[d][ends[d]] = 0.0f;
+        queues[d].clear();
+        queues[d].push_back(QueueEntry(0.0f, ends[d]));
+    }
+
+    float best = INFINITE_MINUTES;
+    float bestMiles = 0.0f;
+    int direction = 0;
+    while (!queues[0].empty() || !queues[1].empty()) {
+        if (queues[direction].empty() || queues[direction].front().first >= best) {
+            queues[direction].clear();
+            direction = 1 - direction;
+            continue;
+        }
+
+        const std::vector<std::uint32_t>& begin = direction == 0 ? network.upwardBegin : network.downwardBegin;
+        const std::vector<RoadNetwork::Arc>& arcs = direction == 0 ? network.upwardArcs : network.downwardArcs;
+        std::vector<QueueEntry>& heap = queues[direction];
+        std::pop_heap(heap.begin(), heap.end(), std::greater<QueueEntry>());
+        QueueEntry top = heap.back();
+        heap.pop_back();
+        std::uint32_t node = top.second;
+
+        if (top.first <= minutes[direction][node] && !stalled(direction, node, top.first)) {
+            int other = 1 - direction;
+            if (stamp[other][node] == currentStamp && top.first + minutes[other][node] < best) {
+                best = top.first + minutes[other][node];
+                bestMiles = miles[direction][node] + miles[other][node];
+            }
+            for (std::uint32_t i = begin[node]; i < begin[node + 1]; ++i) {
+                std::uint32_t next = arcs[i].head;
+                float candidate = top.first + arcs[i].minutes;
+                if (stamp[direction][next] != currentStamp || candidate < minutes[direction][next]) {
+                    stamp[direction][next] = currentStamp;
+                    minutes[direction][next] = candidate;
+                    miles[direction][next] = miles[direction][node] + arcs[i].miles;
+                    heap.push_back(QueueEntry(candidate, next));
+                    std::push_heap(heap.begin(), heap.end(), std::greater<QueueEntry>());
+                }
+            }
+        }
+        direction = 1 - direction;
+    }
+
+    if (best != INFINITE_MINUTES) {
+        leg.minutes = best;
+        leg.miles = bestMiles;
+    }
+    return true;
+}
+
+bool RouteQuery::route(const std::string& from, const std::string& to, RouteLeg& leg) {
+    LocationID fromID, toID;
+    if (!LocationTable::global().find(from, fromID) || !LocationTable::global().find(to, toID)) {
+        return false;
+    }
+    return route(fromID, toID, leg);
+}
+
+bool RouteQuery::assignDistance(Ride& ride) {
+    RouteLeg leg;
+    if (ride.isFareRecorded() || !route(ride.getPickupID(), ride.getDropoffID(), leg) || !leg.reachable()) {
+        return false;
+    }
+    ride.setDistance(leg.miles);
+    return true;
+}
+
+void RouteQuery::table(const std::vector<LocationID>& sources, const std::vector<LocationID>& targets,
+                       std::vector<RouteLeg>& legs) {
+    RouteLeg unreachable;
+    unreachable.minutes = std::numeric_limits<double>::infinity();
+    unreachable.miles = 0.0;
+    legs.assign(sources.size() * targets.size(), unreachable);
+
+    // Backward search from every target leaves (target, cost) in the bucket of each
+    // vertex it settles
+    buckets.clear();
+    for (size_t t = 0; t < targets.size(); ++t) {
+        std::uint32_t node;
+        if (!nodeFor(targets[t], node)) {
+            continue;
+        }
+        upwardSearch(1, node, true);
+        for (size_t i = 0; i < settled.size(); ++i) {
+            Bucket entry;
+            entry.target = static_cast<std::uint32_t>(t);
+            entry.minutes = minutes[1][settled[i]];
+            entry.miles = miles[1][settled[i]];
+            buckets[settled[i]].push_back(entry);
+        }
+    }
+
+    // Forward search from every source combines with the buckets it meets
+    for (size_t s = 0; s < sources.size(); ++s) {
+        std::uint32_t node;
+        if (!nodeFor(sources[s], node)) {
+            continue;
+        }
+        upwardSearch(0, node, true);
+        RouteLeg* row = &legs[s * targets.size()];
+        for (size_t i = 0; i < settled.size(); ++i) {
+            std::unordered_map<std::uint32_t, std::vector<Bucket> >::const_iterator it = buckets.find(settled[i]);
+            if (it == buckets.end()) {
+                continue;
+            }
+            float forwardMinutes = minutes[0][settled[i]];
+            float forwardMiles = miles[0][settled[i]];
+            for (size_t b = 0; b < it->second.size(); ++b) {
+                const Bucket& entry = it->second[b];
+                double total = forwardMinutes + entry.minutes;
+                if (total < row[entry.target].minutes) {
+                    row[entry.target].minutes = total;
+                    row[entry.target].miles = forwardMiles + entry.miles;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef ROADNETWORK_H
+#define ROADNETWORK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "LocationTable.h"
+#include "Ride.h"
+
+// Travel cost between two locations along the fastest route
+struct RouteLeg {
+    double minutes;     // Infinity when unreachable
+    double miles;
+
+    bool reachable() const { return minutes != std::numeric_limits<double>::infinity(); }
+};
+
+// Road graph over named locations, preprocessed into a contraction hierarchy.
+//
+// Graph file format, one item per line ('#' starts a comment):
+//   v <id> <location name>             vertex; the name may contain spaces
+//   e <from> <to> <miles> <minutes>    two-way road
+//   a <from> <to> <miles> <minutes>    one-way road
+//
+// load() orders the vertices by importance and contracts them one by one, adding a
+// shortcut wherever a shortest path ran through the contracted vertex. A query then
+// only searches upwards from both ends and settles a few hundred vertices, even on
+// graphs with millions of them. Routes minimize travel time; miles are those of the
+// fastest route. The network is immutable after load(); use RouteQuery to query it.
+class RoadNetwork {
+private:
+    struct Arc {
+        std::uint32_t head;
+        float minutes;
+        float miles;
+    };
+
+    std::unordered_map<LocationID, std::uint32_t> nodeOf; // Location -> vertex
+    std::vector<std::uint32_t> upwardBegin;     // Forward search: arcs to higher vertices
+    std::vector<Arc> upwardArcs;
+    std::vector<std::uint32_t> downwardBegin;   // Backward search: arcs from higher vertices, reversed
+    std::vector<Arc> downwardArcs;
+    std::size_t roadCount;
+    std::size_t shortcutCount;
+
+    void contract(std::uint32_t nodeCount, const std::vector<std::pair<std::uint32_t, Arc> >& arcs);
+
+    friend class RouteQuery;
+
+public:
+    // Constructor
+    RoadNetwork();
+
+    // Read a graph file and build the hierarchy; returns false (and reports why) on error
+    bool load(const std::string& path);
+
+    bool hasLocation(LocationID location) const { return nodeOf.find(location) != nodeOf.end(); }
+    std::size_t getNodeCount() const { return nodeOf.size(); }
+    std::size_t getRoadCount() const { return roadCount; }
+    std::size_t getShortcutCount() const { return shortcutCount; }
+};
+
+// Query workspace for a RoadNetwork. Each thread needs its own RouteQuery; the
+// network itself is shared read-only.
+class RouteQuery {
+private:
+    typedef std::pair<float, std::uint32_t> QueueEntry;
+
+    struct Bucket {
+        std::uint32_t target;
+        float minutes;
+        float miles;
+    };
+
+    const RoadNetwork& network;
+    // Per-direction labels, valid only where stamp == currentStamp (no clearing per query)
+    std::vector<float> minutes[2];
+    std::vector<float> miles[2];
+    std::vector<std::uint32_t> stamp[2];
+    std::uint32_t currentStamp;
+    std::vector<QueueEntry> queues[2];
+    std::vector<std::uint32_t> settled;
+    std::unordered_map<std::uint32_t, std::vector<Bucket> > buckets;
+
+    void nextStamp();
+    bool stalled(int direction, std::uint32_t node, float nodeMinutes) const;
+    void upwardSearch(int direction, std::uint32_t source, bool recordSettled);
+    bool nodeFor(LocationID location, std::uint32_t& node) const;
+
+public:
+    // Constructor
+    explicit RouteQuery(const RoadNetwork& roadNetwork);
+
+    // Fastest route between two locations; false if either is not in the network
+    bool route(LocationID from, LocationID to, RouteLeg& leg);
+    bool route(const std::string& from, const std::string& to, RouteLeg& leg);
+
+    // Set ride.distance to the road distance between its pickup and dropoff; returns
+    // false (ride unchanged) if unknown, unreachable or already recorded with a driver
+    // or rider, whose fare aggregates hold the old fare()
+    bool assignDistance(Ride& ride);
+
+    // Many-to-many: legs[i * targets.size() + j] is the route sources[i] -> targets[j].
+    // Costs one backward search per target plus one forward search per source.
+    void table(const std::vector<LocationID>& sources, const std::vector<LocationID>& targets,
+               std::vector<RouteLeg>& legs);
+};
+
+#endif // ROADNETWORK_H
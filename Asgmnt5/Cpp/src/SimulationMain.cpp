@@ -0,0 +1,29 @@
+#include <cstdlib>
+#include <iostream>
+#include "CitySimulation.h"
+
+// Usage: city_simulation [seed] [hours] [drivers] [requestsPerHour]
+int main(int argc, char* argv[]) {
+    SimulationConfig config;
+    if (argc > 1) config.seed = std::strtoull(argv[1], nullptr, 10);
+    if (argc > 2) config.durationHours = std::atof(argv[2]);
+    if (argc > 3) config.driverCount = std::atoi(argv[3]);
+    if (argc > 4) config.requestsPerHour = std::atof(argv[4]);
+
+    if (config.driverCount <= 0 || config.requestsPerHour <= 0.0 || !config.isValid()) {
+        std::cout << "Invalid arguments. Usage: city_simulation [seed] [hours] [drivers] [requestsPerHour]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << " ***  CITY SIMULATION  ***" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Seed: " << config.seed << ", hours: " << config.durationHours
+              << ", drivers: " << config.driverCount << ", requests/hour: " << config.requestsPerHour << std::endl;
+
+    CitySimulation simulation(config);
+    SimulationReport report = simulation.run();
+    report.print();
+
+    return 0;
+}
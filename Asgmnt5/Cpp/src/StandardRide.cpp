@@ -1,23 +1,31 @@
 #include "StandardRide.h"
+#include "FarePolicy.h"
 
-// Define the static constant
-const double StandardRide::RATE_PER_MILE = 1.5;
+// Define the static constant (the rate itself lives in FarePolicy)
+const double StandardRide::RATE_PER_MILE = FarePolicy<RideType::Standard>::ratePerMile();
 
 StandardRide::StandardRide(int id, const std::string& pickup, const std::string& dropoff, double dist)
     : Ride(id, pickup, dropoff, dist) {
 }
 
+StandardRide::StandardRide(int id, LocationID pickup, LocationID dropoff, double dist)
+    : Ride(id, pickup, dropoff, dist) {
+}
+
 double StandardRide::fare() const {
-    return baseFare + (distance * RATE_PER_MILE);
+    return (baseFare + (distance * RATE_PER_MILE)) * surgeMultiplier;
 }
 
-void StandardRide::rideDetails() const {
-    std::cout << "=== Standard Ride Details ===" << std::endl;
-    std::cout << "Ride ID: " << rideID << std::endl;
-    std::cout << "Pickup: " << pickupLocation << std::endl;
-    std::cout << "Dropoff: " << dropoffLocation << std::endl;
-    std::cout << "Distance: " << distance << " miles" << std::endl;
-    std::cout << "Rate: $" << RATE_PER_MILE << " per mile" << std::endl;
-    std::cout << "Fare: $" << fare() << std::endl;
-    std::cout << "=============================" << std::endl;
+void StandardRide::rideDetails(std::ostream& out) const {
+    out << "=== Standard Ride Details ===\n";
+    out << "Ride ID: " << rideID << '\n';
+    out << "Pickup: " << getPickupLocation() << '\n';
+    out << "Dropoff: " << getDropoffLocation() << '\n';
+    out << "Distance: " << distance << " miles\n";
+    out << "Rate: $" << RATE_PER_MILE << " per mile\n";
+    if (surgeMultiplier != 1.0) {
+        out << "Surge: x" << surgeMultiplier << '\n';
+    }
+    out << "Fare: $" << fare() << '\n';
+    out << "=============================\n";
 }
\ No newline at end of file
@@ -10,12 +10,15 @@ private:
 public:
     // Constructor
     StandardRide(int id, const std::string& pickup, const std::string& dropoff, double dist);
+    StandardRide(int id, LocationID pickup, LocationID dropoff, double dist);
     
     // Override the virtual fare method (polymorphism)
     double fare() const override;
     
     // Override rideDetails to include ride type
-    void rideDetails() const override;
+    void rideDetails(std::ostream& out = std::cout) const override;
+    
+    RideType getRideType() const override { return RideType::Standard; }
 };
 
 #endif // STANDARDRIDE_H
\ No newline at end of file
@@ -0,0 +1,118 @@
+#include "SurgeEngine.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+SurgeEngine::SurgeEngine(int surgeZones, const SurgeConfig& surgeConfig)
+    : zoneCount(surgeZones > 0 ? surgeZones : 0), config(surgeConfig), zones(new Zone[zoneCount]) {
+    for (int z = 0; z < zoneCount; ++z) {
+        for (int b = 0; b < BUCKET_COUNT; ++b) {
+            zones[z].buckets[b].store(0, std::memory_order_relaxed);
+        }
+        zones[z].availableDrivers.store(0, std::memory_order_relaxed);
+    }
+}
+
+void SurgeEngine::recordRequest(int zone, std::time_t now) {
+    if (!validZone(zone)) {
+        std::cout << "Invalid surge zone: " << zone << std::endl;
+        return;
+    }
+
+    std::uint32_t index = static_cast<std::uint32_t>(now / BUCKET_SECONDS);
+    std::atomic<std::uint64_t>& bucket = zones[zone].buckets[index % BUCKET_COUNT];
+    std::uint64_t current = bucket.load(std::memory_order_relaxed);
+    for (;;) {
+        std::uint32_t stamp = static_cast<std::uint32_t>(current >> 32);
+        std::uint64_t desired;
+        if (stamp == index) {
+            desired = current + 1;
+        } else if (stamp < index) {
+            desired = (static_cast<std::uint64_t>(index) << 32) | 1; // Reuse an expired bucket
+        } else {
+            return; // Request older than the whole window
+        }
+        if (bucket.compare_exchange_weak(current, desired, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+void SurgeEngine::setAvailableDrivers(int zone, int count) {
+    if (validZone(zone)) {
+        zones[zone].availableDrivers.store(count, std::memory_order_relaxed);
+    }
+}
+
+void SurgeEngine::driverAvailable(int zone) {
+    if (validZone(zone)) {
+        zones[zone].availableDrivers.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SurgeEngine::driverBusy(int zone) {
+    if (validZone(zone)) {
+        zones[zone].availableDrivers.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+int SurgeEngine::getRequests(int zone, Window window, std::time_t now) const {
+    if (!validZone(zone)) {
+        return 0;
+    }
+
+    int span = window == Window::OneMinute ? 60 / BUCKET_SECONDS
+             : window == Window::FiveMinutes ? 300 / BUCKET_SECONDS
+             : BUCKET_COUNT;
+    std::uint32_t index = static_cast<std::uint32_t>(now / BUCKET_SECONDS);
+
+    int total = 0;
+    for (int k = 0; k < span && static_cast<std::uint32_t>(k) <= index; ++k) {
+        std::uint32_t wanted = index - k;
+        std::uint64_t value = zones[zone].buckets[wanted % BUCKET_COUNT].load(std::memory_order_relaxed);
+        if (static_cast<std::uint32_t>(value >> 32) == wanted) {
+            total += static_cast<int>(value & 0xFFFFFFFFu);
+        }
+    }
+    return total;
+}
+
+int SurgeEngine::getAvailableDrivers(int zone) const {
+    return validZone(zone) ? std::max(0, zones[zone].availableDrivers.load(std::memory_order_relaxed)) : 0;
+}
+
+double SurgeEngine::getMultiplier(int zone, std::time_t now) const {
+    // Blend the windows so a short spike surges quickly but a sustained one holds
+    double demandPerMinute = 0.5 * getRequests(zone, Window::OneMinute, now)
+                           + 0.3 * getRequests(zone, Window::FiveMinutes, now) / 5.0
+                           + 0.2 * getRequests(zone, Window::FifteenMinutes, now) / 15.0;
+    if (demandPerMinute <= 0.0) {
+        return 1.0;
+    }
+
+    double capacityPerMinute = getAvailableDrivers(zone) * config.ridesPerDriverPerMinute;
+    if (capacityPerMinute <= 0.0) {
+        return config.maxMultiplier;
+    }
+
+    double ratio = demandPerMinute / capacityPerMinute;
+    if (ratio <= 1.0) {
+        return 1.0;
+    }
+    double multiplier = std::min(1.0 + config.sensitivity * (ratio - 1.0), config.maxMultiplier);
+    return std::floor(multiplier / config.step + 1e-9) * config.step;
+}
+
+double SurgeEngine::priceRide(Ride& ride, int zone, std::time_t now) {
+    if (ride.isFareRecorded()) {
+        std::cout << "Ride " << ride.getRideID() << " is already recorded; price it before assignment" << std::endl;
+        return ride.getSurgeMultiplier();
+    }
+    recordRequest(zone, now);
+    double multiplier = getMultiplier(zone, now);
+    ride.setSurgeMultiplier(multiplier);
+    if (ride.getRequestTime() == 0) {
+        ride.setRequestTime(now);
+    }
+    return multiplier;
+}
@@ -0,0 +1,70 @@
+#ifndef SURGEENGINE_H
+#define SURGEENGINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include "Ride.h"
+
+struct SurgeConfig {
+    double ridesPerDriverPerMinute; // Service capacity of one available driver
+    double sensitivity;             // Multiplier growth per unit of excess demand ratio
+    double maxMultiplier;
+    double step;                    // Multipliers are rounded down to this step
+
+    SurgeConfig() : ridesPerDriverPerMinute(1.0 / 15.0), sensitivity(0.5), maxMultiplier(3.0), step(0.1) {}
+};
+
+// Per-zone demand-sensitive pricing.
+// Each zone keeps its ride requests in a ring of 10-second buckets covering 15 minutes.
+// A bucket is one 64-bit atomic packing (bucket time, count), so recording a request is a
+// single CAS with no locks, stale buckets reset themselves when reused, and window sums
+// (1/5/15 minutes) read a fixed number of buckets regardless of request volume.
+class SurgeEngine {
+public:
+    enum class Window {
+        OneMinute,
+        FiveMinutes,
+        FifteenMinutes
+    };
+
+private:
+    static const int BUCKET_SECONDS = 10;
+    static const int BUCKET_COUNT = 90; // 15 minutes
+
+    struct Zone {
+        std::atomic<std::uint64_t> buckets[BUCKET_COUNT]; // (bucket index << 32) | count
+        std::atomic<int> availableDrivers;
+    };
+
+    int zoneCount;
+    SurgeConfig config;
+    std::unique_ptr<Zone[]> zones;
+
+    bool validZone(int zone) const { return zone >= 0 && zone < zoneCount; }
+
+    SurgeEngine(const SurgeEngine&);            // Non-copyable
+    SurgeEngine& operator=(const SurgeEngine&);
+
+public:
+    // Constructor
+    explicit SurgeEngine(int surgeZones, const SurgeConfig& surgeConfig = SurgeConfig());
+
+    // Demand and supply updates; all thread-safe and lock-free
+    void recordRequest(int zone, std::time_t now);
+    void setAvailableDrivers(int zone, int count);
+    void driverAvailable(int zone);
+    void driverBusy(int zone);
+
+    // Queries
+    int getRequests(int zone, Window window, std::time_t now) const;
+    int getAvailableDrivers(int zone) const;
+    double getMultiplier(int zone, std::time_t now) const;
+
+    // Record the ride's request and stamp the current multiplier on it; returns the multiplier.
+    // Call it before the ride is given to a Driver or Rider: a recorded ride keeps its price.
+    double priceRide(Ride& ride, int zone, std::time_t now);
+};
+
+#endif // SURGEENGINE_H
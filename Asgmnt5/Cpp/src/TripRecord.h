@@ -0,0 +1,41 @@
+#ifndef TRIPRECORD_H
+#define TRIPRECORD_H
+
+#include <cstdint>
+#include "Ride.h"
+
+// Fixed-size binary record of one completed ride, as persisted by RideJournal.
+// Plain data with explicit field widths so it can be read straight out of a
+// memory-mapped file without any deserialization.
+struct TripRecord {
+    std::int64_t requestTime;
+    std::int32_t rideID;
+    std::int32_t driverID;
+    std::int32_t riderID;
+    std::uint32_t type;     // RideType
+    std::uint32_t pickup;   // Location id (see RideJournalReader::resolveLocation)
+    std::uint32_t dropoff;
+    double distance;
+    double fare;
+
+    RideType getRideType() const { return static_cast<RideType>(type); }
+};
+
+static_assert(sizeof(TripRecord) == 48, "TripRecord layout is part of the on-disk format");
+
+// Build a record from a live ride
+inline TripRecord makeTripRecord(const Ride& ride, int driverID, int riderID) {
+    TripRecord record;
+    record.requestTime = static_cast<std::int64_t>(ride.getRequestTime());
+    record.rideID = ride.getRideID();
+    record.driverID = driverID;
+    record.riderID = riderID;
+    record.type = static_cast<std::uint32_t>(ride.getRideType());
+    record.pickup = ride.getPickupID();
+    record.dropoff = ride.getDropoffID();
+    record.distance = ride.getDistance();
+    record.fare = ride.fare();
+    return record;
+}
+
+#endif // TRIPRECORD_H
@@ -0,0 +1,36 @@
+@echo off
+echo ==========================================
+echo    RIDE SHARING SYSTEM - BENCHMARKS
+echo ==========================================
+echo.
+
+
+echo Compilation Start ... 
+
+cl /EHsc /O2 /std:c++11 RideBenchmark.cpp Ride.cpp StandardRide.cpp PremiumRide.cpp Driver.cpp DriverLeaderboard.cpp Rider.cpp RidePool.cpp FareStats.cpp LocationTable.cpp RideReport.cpp /Fe:ride_benchmark.exe >nul 2>&1
+if %errorlevel% == 0 (
+    echo Compilation successful.
+    del *.obj >nul 2>&1
+    goto :success
+) else (
+    echo Compilation failed.
+)
+
+
+goto :end
+
+:success
+echo.
+echo RUNNING THE BENCHMARKS...
+echo Usage: ride_benchmark.exe [maxRides] [jsonPath]
+echo.
+if exist ride_benchmark.exe (
+    ride_benchmark.exe %*
+) else (
+    echo Error: Executable not found!
+)
+
+:end
+echo.
+echo Press any key to exit...
+pause >nul
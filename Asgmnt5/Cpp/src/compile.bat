@@ -7,7 +7,7 @@ echo.
 
 echo Compilation Start ... 
 
-cl /EHsc /std:c++11 main.cpp Ride.cpp StandardRide.cpp PremiumRide.cpp Driver.cpp Rider.cpp /Fe:ride_sharing_system.exe >nul 2>&1
+cl /EHsc /std:c++11 main.cpp Ride.cpp StandardRide.cpp PremiumRide.cpp Driver.cpp DriverLeaderboard.cpp Rider.cpp RidePool.cpp FareStats.cpp LocationTable.cpp /Fe:ride_sharing_system.exe >nul 2>&1
 if %errorlevel% == 0 (
     echo Compilation successful.
     del *.obj >nul 2>&1
@@ -6,6 +6,7 @@
 #include "PremiumRide.h"
 #include "Driver.h"
 #include "Rider.h"
+#include "RidePool.h"
 
 // Function to demonstrate polymorphism with different ride types
 void demonstratePolymorphism(const std::vector<std::shared_ptr<Ride>>& rides) {
@@ -42,7 +43,7 @@ void demonstrateEncapsulation() {
     std::cout << "Rider name (via getter): " << rider.getName() << std::endl;
     
     // Cannot directly access driver.assignedRides or rider.requestedRides - they are private!
-    // We must use public methods: addRide(), requestRide(), getAssignedRides(), etc.
+    // We must use public methods: addRide(), requestRide(), viewAssignedRides(), etc.
 }
 
 int main() {
@@ -53,6 +54,10 @@ int main() {
     // Demonstrate encapsulation
     demonstrateEncapsulation();
     
+    // Rides are allocated from a pool; the handles are non-owning, so the pool must
+    // outlive the riders and drivers holding them (it is declared first, destroyed last)
+    RidePool ridePool;
+    
     // Create riders and drivers
     Rider rider1(201, "John Doe");
     Rider rider2(202, "Jane Smith");
@@ -68,12 +73,12 @@ int main() {
     std::vector<std::shared_ptr<Ride>> allRides;
     
     // Standard rides
-    auto ride1 = std::make_shared<StandardRide>(1001, "Downtown", "Airport", 12.5);
-    auto ride2 = std::make_shared<StandardRide>(1002, "Mall", "University", 8.3);
+    auto ride1 = RidePool::handle(ridePool.create<StandardRide>(1001, "Downtown", "Airport", 12.5));
+    auto ride2 = RidePool::handle(ridePool.create<StandardRide>(1002, "Mall", "University", 8.3));
     
     // Premium rides
-    auto ride3 = std::make_shared<PremiumRide>(1003, "Hotel", "Business District", 15.0);
-    auto ride4 = std::make_shared<PremiumRide>(1004, "Home", "Concert Hall", 6.8);
+    auto ride3 = RidePool::handle(ridePool.create<PremiumRide>(1003, "Hotel", "Business District", 15.0));
+    auto ride4 = RidePool::handle(ridePool.create<PremiumRide>(1004, "Home", "Concert Hall", 6.8));
     
     allRides.push_back(ride1);
     allRides.push_back(ride2);
@@ -120,6 +125,12 @@ int main() {
     rider1.viewRides();
     driver1.displayRideHistory();
     
+    // Walk a history through a filtered view instead of copying it
+    std::cout << "\nPremium rides driven by " << driver2.getName() << ":" << std::endl;
+    for (const Ride& ride : driver2.filterAssignedRides(RideFilter().ofType(RideType::Premium))) {
+        std::cout << "  Ride " << ride.getRideID() << " (" << ride.getDistance() << " miles)" << std::endl;
+    }
+    
     // Demonstrate fare calculation differences (polymorphism)
     std::cout << "   FARE COMPARISON (POLYMORPHISM)" << std::endl;
     
@@ -0,0 +1,36 @@
+@echo off
+echo ==========================================
+echo    RIDE SHARING SYSTEM - SELF-TEST
+echo ==========================================
+echo.
+
+
+echo Compilation Start ... 
+
+cl /EHsc /O2 /std:c++11 RideSelfTest.cpp DispatchService.cpp RideJournal.cpp RideColumns.cpp MappedFile.cpp RideAnalytics.cpp BatchMatcher.cpp RoadNetwork.cpp RideRegistry.cpp SurgeEngine.cpp Ride.cpp StandardRide.cpp PremiumRide.cpp Driver.cpp DriverLeaderboard.cpp Rider.cpp RidePool.cpp FareStats.cpp LocationTable.cpp /Fe:ride_selftest.exe >nul 2>&1
+if %errorlevel% == 0 (
+    echo Compilation successful.
+    del *.obj >nul 2>&1
+    goto :success
+) else (
+    echo Compilation failed.
+)
+
+
+goto :end
+
+:success
+echo.
+echo RUNNING THE SELF-TEST...
+echo Usage: ride_selftest.exe [burstRequests]
+echo.
+if exist ride_selftest.exe (
+    ride_selftest.exe %*
+) else (
+    echo Error: Executable not found!
+)
+
+:end
+echo.
+echo Press any key to exit...
+pause >nul
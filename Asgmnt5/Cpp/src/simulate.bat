@@ -0,0 +1,36 @@
+@echo off
+echo ==========================================
+echo    RIDE SHARING SYSTEM - CITY SIMULATION
+echo ==========================================
+echo.
+
+
+echo Compilation Start ... 
+
+cl /EHsc /O2 /std:c++11 SimulationMain.cpp CitySimulation.cpp Ride.cpp StandardRide.cpp PremiumRide.cpp Driver.cpp DriverLeaderboard.cpp Rider.cpp RidePool.cpp FareStats.cpp LocationTable.cpp /Fe:city_simulation.exe >nul 2>&1
+if %errorlevel% == 0 (
+    echo Compilation successful.
+    del *.obj >nul 2>&1
+    goto :success
+) else (
+    echo Compilation failed.
+)
+
+
+goto :end
+
+:success
+echo.
+echo RUNNING THE SIMULATION...
+echo Usage: city_simulation.exe [seed] [hours] [drivers] [requestsPerHour]
+echo.
+if exist city_simulation.exe (
+    city_simulation.exe %*
+) else (
+    echo Error: Executable not found!
+)
+
+:end
+echo.
+echo Press any key to exit...
+pause >nul
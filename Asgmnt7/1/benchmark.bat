@@ -0,0 +1,37 @@
+@echo off
+echo ==========================================
+echo    STATISTICS KERNELS - BENCHMARKS
+echo ==========================================
+echo.
+
+
+echo Compilation Start ... 
+
+cl /W4 /O2 /DSTATISTICS_NO_MAIN /Fe:stats_bench.exe stats_bench.c statistics.c stats_select.c stats_stream.c stats_mode.c stats_simd.c stats_parallel.c stats_input.c stats_window.c psapi.lib >nul 2>&1
+if %errorlevel% == 0 (
+    echo Compilation successful.
+    del *.obj >nul 2>&1
+    goto :success
+) else (
+    echo Compilation failed.
+    echo Or build with: gcc -std=c99 -O2 -DSTATISTICS_NO_MAIN -o stats_bench stats_bench.c statistics.c stats_select.c stats_stream.c stats_mode.c stats_simd.c stats_parallel.c stats_input.c stats_window.c -pthread -lm
+)
+
+
+goto :end
+
+:success
+echo.
+echo RUNNING THE BENCHMARKS...
+echo Usage: stats_bench.exe [maxN] [--no-check] [--languages]
+echo.
+if exist stats_bench.exe (
+    stats_bench.exe %*
+) else (
+    echo Error: Executable not found!
+)
+
+:end
+echo.
+echo Press any key to exit...
+pause >nul
@@ -0,0 +1,47 @@
+@echo off
+REM Direct compilation using MSVC compiler
+
+echo ========================================
+echo Integers Statistics Calculator using C
+echo ========================================
+
+REM Clean up any existing executable
+if exist "statistics.exe" (
+    echo Cleaning up previous build...
+    del statistics.exe
+)
+
+echo.
+echo Attempting to compile with MSVC...
+cl >nul 2>&1
+if not errorlevel 1 (
+    echo [OK] Found MSVC compiler
+    echo Compiling source files...
+    cl /W4 /O2 /Fe:statistics.exe statistics.c stats_select.c stats_stream.c stats_mode.c stats_simd.c stats_parallel.c stats_input.c stats_window.c
+
+    if not errorlevel 1 (
+        echo [OK] Build successful with MSVC!
+        del *.obj >nul 2>&1
+        goto :done
+    ) else (
+        echo [ERROR] Build failed with MSVC
+        goto :error_exit
+    )
+) else (
+    echo [ERROR] No suitable compiler found!
+    echo Please install Visual Studio Build Tools (includes MSVC)
+    echo or build with: gcc -std=c99 -O2 -o statistics statistics.c stats_select.c stats_stream.c stats_mode.c stats_simd.c stats_parallel.c stats_input.c stats_window.c -pthread -lm
+    goto :error_exit
+)
+
+:done
+echo.
+echo Executable created: statistics.exe
+pause
+exit /b 0
+
+:error_exit
+echo.
+echo Build failed! Please check the error messages above.
+pause
+exit /b 1
@@ -1,10 +1,21 @@
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include "statistics.h"
+#include "stats_select.h"
+#include "stats_mode.h"
+#include "stats_simd.h"
+#include "stats_parallel.h"
+#include "stats_input.h"
+#include "stats_window.h"
 
+// Arrays at least this long are processed on every CPU (see stats_parallel.h)
+#define PARALLEL_THRESHOLD (1 << 20)
 
 // Function to calculate the mean (average) of an array of integers
 double calculateMean(int *arr, int n) {
-    if (n == 0) {
+    if (n <= 0) {
         printf("Num of elements is 0\n");
         return 0.0;
     }
@@ -14,11 +25,13 @@ double calculateMean(int *arr, int n) {
         return 0.0;
     }    
     
-    long long sum = 0;  // Use long long to prevent overflow
-    for (int i = 0; i < n; i++) {
-        sum += arr[i];
+    if (n >= PARALLEL_THRESHOLD) {
+        return parallelMean(arr, (size_t)n, 0);
     }
     
+    // Vectorized 64-bit accumulation (see stats_simd.h)
+    long long sum = sumInts(arr, (size_t)n);
+    
     return (double)sum / n;
 }
 
@@ -57,78 +70,80 @@ void bubbleSort(int *arr, int n) {
 }
 
 // Function to calculate the median of an array of integers
+// Uses linear-time selection instead of sorting; the array is reordered, not sorted
 double calculateMedian(int *arr, int n) {
-    if (n == 0 || !arr) {
+    if (n <= 0 || !arr) {
         printf("Array is empty \n");
         return 0.0;
     }
     
-    // Sort the array first
-    bubbleSort(arr, n);
-    
-    // If odd number of elements, return middle element
-    // If even number of elements, return average of two middle elements
-    if (n % 2 == 1) {
-        return (double)arr[n / 2];
-    }
-    else {
-        return (double)(arr[n / 2 - 1] + arr[n / 2]) / 2.0;
+    // Large arrays: parallel radix selection, which leaves arr untouched
+    if (n >= PARALLEL_THRESHOLD) {
+        return parallelMedian(arr, (size_t)n, 0);
     }
+    
+    // Odd n: the middle element; even n: average of the two middle elements
+    return calculateQuantile(arr, (size_t)n, 0.5);
 }
 
-typedef struct {
-    int value;      // The mode value
-    int frequency;  // Frequency of the mode
-    int count;      // Number of modes (for multimodal distributions)
-} ModeResult;
-
 // Function to calculate the mode of an array of integers
+// Counts in O(n) with a frequency table (see stats_mode.h); the array is not modified.
+// For multimodal data, value is the smallest mode and count the number of modes.
 ModeResult calculateMode(int *arr, int n) {
     ModeResult result = {0, 0, 0};
     
-    if (n == 0 || !arr) {
+    if (n <= 0 || !arr) {
         printf("Array is empty\n");
         return result;
     }
     
-    // Sort the array first (if not already sorted)
-    bubbleSort(arr, n);
+    int smallestMode = 0;
+    size_t frequency = 0;
+    size_t modeCount = 0;
+    if (n >= PARALLEL_THRESHOLD) {
+        modeCount = parallelModes(arr, (size_t)n, 0, &smallestMode, 1, &frequency);
+    } else {
+        FrequencyTable table;
+        if (buildFrequencyTable(&table, arr, (size_t)n) != 0) {
+            freeFrequencyTable(&table);
+            return result;
+        }
+        modeCount = findModes(&table, &smallestMode, 1, &frequency);
+        freeFrequencyTable(&table);
+    }
     
-    int maxFrequency = 0;
-    int currentFrequency = 1;
-    int modeValue = arr[0];
-    int modeCount = 0;
+    result.value = smallestMode;
+    result.frequency = (int)frequency;
+    result.count = (int)modeCount;
     
-    // Count frequencies
-    for (int i = 1; i < n; i++) {
-        if (arr[i] == arr[i - 1]) {
-            currentFrequency++;
-        } else {
-            if (currentFrequency > maxFrequency) {
-                maxFrequency = currentFrequency;
-                modeValue = arr[i - 1];
-                modeCount = 1;
-            } else if (currentFrequency == maxFrequency) {
-                modeCount++;
-            }
-            currentFrequency = 1;
+    return result;
+}
+
+// Function to display every mode of a multimodal array (up to 10)
+void printModes(int *arr, int n) {
+    int modes[10];
+    size_t frequency = 0;
+    size_t modeCount = 0;
+    if (n >= PARALLEL_THRESHOLD) {
+        modeCount = parallelModes(arr, (size_t)n, 0, modes, 10, &frequency);
+    } else {
+        FrequencyTable table;
+        if (buildFrequencyTable(&table, arr, (size_t)n) != 0) {
+            freeFrequencyTable(&table);
+            return;
         }
+        modeCount = findModes(&table, modes, 10, &frequency);
+        freeFrequencyTable(&table);
     }
     
-    // Check the last element
-    if (currentFrequency > maxFrequency) {
-        maxFrequency = currentFrequency;
-        modeValue = arr[n - 1];
-        modeCount = 1;
-    } else if (currentFrequency == maxFrequency) {
-        modeCount++;
+    printf("Modes: ");
+    for (size_t i = 0; i < modeCount && i < 10; i++) {
+        printf(i == 0 ? "%d" : ", %d", modes[i]);
     }
-    
-    result.value = modeValue;
-    result.frequency = maxFrequency;
-    result.count = modeCount;
-    
-    return result;
+    if (modeCount > 10) {
+        printf(", ... (%zu modes)", modeCount);
+    }
+    printf(" (each appears %zu time(s))\n", frequency);
 }
 
 // Function to display the array
@@ -141,11 +156,109 @@ void printArray(int *arr, int n) {
 }
 
 
+// Function to calculate and display the statistics of an array
+void printStatistics(int *arr, int n) {
+    printf("\n=== Statistics ===\n");
+    
+    // Mean
+    double mean = calculateMean(arr, n);
+    printf("Mean: %.2f\n", mean);
+    
+    // Median (may reorder arr, which mean and mode do not depend on)
+    double median = calculateMedian(arr, n);
+    printf("Median: %.2f\n", median);
+    
+    // Mode
+    ModeResult mode = calculateMode(arr, n);
+    if (mode.count > 1) {
+        printModes(arr, n);
+    } else {
+        printf("Mode: %d (appears %d time(s))\n", mode.value, mode.frequency);
+    }
+}
+
+// Function to print one row of the rolling statistics table (forEachWindow callback)
+static void printWindow(size_t start, const WindowStats *stats, void *context) {
+    (void)context;
+    printf("%12zu %14.2f %16.2f %14.2f %12d %10zu\n", start, stats->mean, stats->variance,
+           stats->median, stats->mode, stats->modeFrequency);
+}
+
+// Function to display the statistics of every full window of width values.
+// Rows are printed as the window slides, so memory stays O(width) however long the input.
+int printRollingStatistics(const int *arr, size_t n, size_t width) {
+    if (width > n) {
+        printf("Window width %zu exceeds the %zu integers read\n", width, n);
+        return 1;
+    }
+    
+    printf("\n=== Rolling Statistics (window %zu) ===\n", width);
+    printf("%12s %14s %16s %14s %12s %10s\n", "Start", "Mean", "Variance", "Median", "Mode", "Frequency");
+    return forEachWindow(arr, n, width, printWindow, NULL) == 0 ? 0 : 1;
+}
+
+// Function to calculate statistics of a data file:
+// statistics [--text|--int32|--int64] [--window <width>] <file>
+int runFile(int argc, char *argv[]) {
+    InputFormat format = INPUT_TEXT;
+    size_t width = 0;
+    int i = 1;
+    
+    for (; i < argc - 1; i++) {
+        if (strcmp(argv[i], "--text") == 0) {
+            format = INPUT_TEXT;
+        } else if (strcmp(argv[i], "--int32") == 0) {
+            format = INPUT_INT32;
+        } else if (strcmp(argv[i], "--int64") == 0) {
+            format = INPUT_INT64;
+        } else if (strcmp(argv[i], "--window") == 0 && i + 2 < argc && atoi(argv[i + 1]) > 0) {
+            width = (size_t)atoi(argv[++i]);
+        } else {
+            break;
+        }
+    }
+    if (i != argc - 1) {
+        printf("Usage: %s [--text | --int32 | --int64] [--window <width>] <file>\n", argv[0]);
+        return 1;
+    }
+    const char *path = argv[i];
+    
+    IntDataset dataset;
+    if (loadIntDataset(&dataset, path, format) != 0) {
+        freeIntDataset(&dataset);
+        return 1;
+    }
+    if (dataset.count == 0 || dataset.count > INT_MAX) {
+        printf(dataset.count == 0 ? "%s contains no integers\n" : "%s has too many integers\n", path);
+        freeIntDataset(&dataset);
+        return 1;
+    }
+    
+    printf("=== Integers Statistics Calculations ===\n\n");
+    printf("Loaded %zu integers from %s\n", dataset.count, path);
+    
+    int status = 0;
+    if (width > 0) {
+        status = printRollingStatistics(dataset.values, dataset.count, width);
+    } else {
+        printStatistics(dataset.values, (int)dataset.count);
+    }
+    
+    freeIntDataset(&dataset);
+    return status;
+}
+
+#ifndef STATISTICS_NO_MAIN
 // Main function to demonstrate statistics calculations
-int main() {
+// With a file argument the data is read from the file, otherwise interactively
+int main(int argc, char *argv[]) {
     int n;
     int *arr = NULL;
     
+    if (argc > 1) {
+        return runFile(argc, argv);
+    }
+    
     printf("=== Integers Statistics Calculations ===\n\n");
     
     // Get number of elements from user
@@ -176,36 +289,12 @@ int main() {
     printf("\n");
     printArray(arr, n);
     
-    // Create a copy for median calculation (since it modifies the array)
-    int *arrCopy = (int *)malloc(n * sizeof(int));
-    if (arrCopy == NULL) {
-        printf("Memory allocation failed\n");
-        free(arr);
-        return 1;
-    }
-    
-    for (int i = 0; i < n; i++) {
-        arrCopy[i] = arr[i];
-    }
-    
     // Calculate and display statistics
-    printf("\n=== Statistics ===\n");
-    
-    // Mean
-    double mean = calculateMean(arr, n);
-    printf("Mean: %.2f\n", mean);
-    
-    // Median
-    double median = calculateMedian(arrCopy, n);
-    printf("Median: %.2f\n", median);
-    
-    // Mode
-    ModeResult mode = calculateMode(arr, n);
-    printf("Mode: %d (appears %d time(s))\n", mode.value, mode.frequency);
+    printStatistics(arr, n);
     
     // Free dynamically allocated memory
     free(arr);
-    free(arrCopy);
  
     return 0;
 }
+#endif // STATISTICS_NO_MAIN
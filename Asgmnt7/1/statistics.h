@@ -0,0 +1,19 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+// The calculator's own statistics kernels (statistics.c). Build statistics.c with
+// STATISTICS_NO_MAIN to link them into another program, e.g. stats_bench.c.
+
+typedef struct {
+    int value;      // The mode value
+    int frequency;  // Frequency of the mode
+    int count;      // Number of modes (for multimodal distributions)
+} ModeResult;
+
+double calculateMean(int *arr, int n);
+void swap(int *a, int *b);
+void bubbleSort(int *arr, int n);
+double calculateMedian(int *arr, int n);    // Reorders arr
+ModeResult calculateMode(int *arr, int n);
+
+#endif // STATISTICS_H
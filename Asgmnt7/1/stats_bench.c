@@ -0,0 +1,419 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L // clock_gettime and getrusage under -std=c99
+#endif
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "statistics.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+// Benchmark and differential check of the statistics kernels.
+// Usage: stats_bench [maxN] [--no-check] [--languages]
+// Times calculateMean, calculateMedian, calculateMode and bubbleSort for n = 1e3, 1e4,
+// ... up to maxN (default 1e7, at most 1e9) on six distributions, and checks every
+// result against a plain sort-based reference. --languages also feeds the small
+// datasets to statistics_calculator.py and statistics.ml and compares their output.
+// Exits with 1 if any result differs.
+
+#define DEFAULT_MAX_N 10000000LL
+#define MAX_N 1000000000LL
+#define BUBBLE_LIMIT 10000      // bubbleSort is O(n^2)
+#define LANGUAGE_LIMIT 10000    // statistics.ml counts with an association list
+#define MIN_SECONDS 0.2         // Small sizes are repeated for at least this long
+
+typedef enum {
+    DIST_UNIFORM,       // Full int range
+    DIST_SORTED,
+    DIST_REVERSE,
+    DIST_DUPLICATES,    // 16 distinct values
+    DIST_EXTREMES,      // Alternating values near INT_MIN and INT_MAX, all distinct
+    DIST_M3_KILLER,     // Musser's median-of-3 killer sequence
+    DIST_COUNT
+} Distribution;
+
+static const char *DIST_NAMES[DIST_COUNT] = {
+    "uniform", "sorted", "reverse", "duplicates", "extremes", "m3killer"
+};
+
+typedef struct {
+    double mean;
+    double median;
+    ModeResult mode;
+} Reference;
+
+static int failures = 0;
+
+// ---------------------------------------------------------------------------
+// Platform
+// ---------------------------------------------------------------------------
+
+static double nowSeconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Function to return the peak resident memory of the process in MB
+static double peakMemoryMB(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0.0;
+    }
+    return (double)counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0.0;
+    }
+#ifdef __APPLE__
+    return (double)usage.ru_maxrss / (1024.0 * 1024.0);    // Bytes
+#else
+    return (double)usage.ru_maxrss / 1024.0;                // KB
+#endif
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Datasets
+// ---------------------------------------------------------------------------
+
+// Function to return the next pseudo-random number (xorshift64*), the same on every platform
+static unsigned long long nextRandom(unsigned long long *state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1DULL;
+}
+
+static void generate(int *arr, size_t n, Distribution dist) {
+    unsigned long long state = 0x9E3779B97F4A7C15ULL ^ (n * 31 + (size_t)dist);
+    for (size_t i = 0; i < n; i++) {
+        switch (dist) {
+        case DIST_UNIFORM:
+            arr[i] = (int)(unsigned int)(nextRandom(&state) >> 32);
+            break;
+        case DIST_SORTED:
+            arr[i] = (int)(i / 4) - (int)(n / 8);
+            break;
+        case DIST_REVERSE:
+            arr[i] = (int)(n / 8) - (int)(i / 4);
+            break;
+        case DIST_DUPLICATES:
+            arr[i] = (int)(nextRandom(&state) >> 60);
+            break;
+        case DIST_EXTREMES:
+            // Overflows int sums and (a + b) / 2 medians; every value is a mode
+            arr[i] = (i & 1) ? INT_MAX - (int)(i / 2) : INT_MIN + (int)(i / 2);
+            break;
+        default: {
+            // Musser's sequence (1-based p, k = n / 2): p <= k holds p when p is odd and
+            // k + p - 1 when even, p > k holds 2 (p - k). A quickselect for the median that
+            // pivots on the median of the first, middle and last value and partitions
+            // Hoare-style (as the SGI STL does) splits off two elements per pass and goes
+            // quadratic; selectKth's budget must keep it linear
+            size_t k = n / 2;
+            size_t p = i + 1;
+            if (p > 2 * k) {
+                arr[i] = (int)n; // Odd n: one largest value at the end
+            } else if (p > k) {
+                arr[i] = (int)(2 * (p - k));
+            } else {
+                arr[i] = (int)((p & 1) ? p : k + p - 1);
+            }
+            break;
+        }
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Reference implementation: sort a copy, then read everything off the runs
+// ---------------------------------------------------------------------------
+
+static int compareInts(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+static void computeReference(const int *arr, size_t n, int *sorted, Reference *ref) {
+    long long sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += arr[i];
+    }
+    ref->mean = (double)sum / (double)n;
+
+    memcpy(sorted, arr, n * sizeof(int));
+    qsort(sorted, n, sizeof(int), compareInts);
+    ref->median = (n % 2) ? (double)sorted[n / 2]
+                          : ((double)sorted[n / 2 - 1] + (double)sorted[n / 2]) / 2.0;
+
+    // Smallest value of highest frequency, and how many values share it
+    ref->mode.value = sorted[0];
+    ref->mode.frequency = 0;
+    ref->mode.count = 0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && sorted[j] == sorted[i]) {
+            j++;
+        }
+        if ((int)(j - i) > ref->mode.frequency) {
+            ref->mode.value = sorted[i];
+            ref->mode.frequency = (int)(j - i);
+            ref->mode.count = 1;
+        } else if ((int)(j - i) == ref->mode.frequency) {
+            ref->mode.count++;
+        }
+        i = j;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Measurements
+// ---------------------------------------------------------------------------
+
+static void printRow(Distribution dist, size_t n, const char *kernel, double seconds, const char *check) {
+    double perSecond = (double)n / seconds;
+    printf("%-12s %12zu %-8s %12.3f %12.1f %10.1f %10.1f  %s\n", DIST_NAMES[dist], n, kernel,
+           seconds * 1e3, perSecond / 1e6, perSecond * sizeof(int) / 1e6, peakMemoryMB(), check);
+}
+
+static const char *verdict(int ok, int checking) {
+    if (!checking) {
+        return "-";
+    }
+    if (!ok) {
+        failures++;
+        return "FAIL";
+    }
+    return "OK";
+}
+
+// Function to time the kernels on one dataset; work is scratch space for the kernels
+// that reorder their input
+static void benchmarkDataset(const int *arr, size_t n, Distribution dist, int *work,
+                             const Reference *ref, int checking) {
+    double elapsed;
+    int runs;
+
+    double mean = 0.0;
+    elapsed = 0.0;
+    for (runs = 0; runs == 0 || elapsed < MIN_SECONDS; runs++) {
+        double start = nowSeconds();
+        mean = calculateMean((int *)arr, (int)n);
+        elapsed += nowSeconds() - start;
+    }
+    printRow(dist, n, "mean", elapsed / runs, verdict(mean == ref->mean, checking));
+
+    double median = 0.0;
+    elapsed = 0.0;
+    for (runs = 0; runs == 0 || elapsed < MIN_SECONDS; runs++) {
+        memcpy(work, arr, n * sizeof(int));
+        double start = nowSeconds();
+        median = calculateMedian(work, (int)n);
+        elapsed += nowSeconds() - start;
+    }
+    printRow(dist, n, "median", elapsed / runs, verdict(median == ref->median, checking));
+
+    ModeResult mode = {0, 0, 0};
+    elapsed = 0.0;
+    for (runs = 0; runs == 0 || elapsed < MIN_SECONDS; runs++) {
+        double start = nowSeconds();
+        mode = calculateMode((int *)arr, (int)n);
+        elapsed += nowSeconds() - start;
+    }
+    printRow(dist, n, "mode", elapsed / runs,
+             verdict(mode.value == ref->mode.value && mode.frequency == ref->mode.frequency
+                     && mode.count == ref->mode.count, checking));
+
+    if (n <= BUBBLE_LIMIT) {
+        int sorted = 1;
+        memcpy(work, arr, n * sizeof(int));
+        double start = nowSeconds();
+        bubbleSort(work, (int)n);
+        elapsed = nowSeconds() - start;
+        for (size_t i = 1; i < n; i++) {
+            sorted &= work[i - 1] <= work[i];
+        }
+        printRow(dist, n, "bubble", elapsed, verdict(sorted, 1));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Python and OCaml implementations
+// ---------------------------------------------------------------------------
+
+// Function to find "label value" in a program's output and read the value after it
+static int findValue(const char *output, const char *label, const char *format, void *value) {
+    const char *line = strstr(output, label);
+    return line != NULL && sscanf(line + strlen(label), format, value) == 1;
+}
+
+// Function to pick the Python interpreter: python3 first, since python is Python 2 or
+// missing on many systems, then python (the usual name on Windows)
+static const char *pythonCommand(void) {
+#ifdef _WIN32
+    const char *quiet = "--version >nul 2>&1";
+#else
+    const char *quiet = "--version >/dev/null 2>&1";
+#endif
+    static const char *candidates[] = { "python3", "python" };
+    char line[64];
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++) {
+        snprintf(line, sizeof(line), "%s %s", candidates[i], quiet);
+        if (system(line) == 0) {
+            return candidates[i];
+        }
+    }
+    return "python3"; // Neither runs: report it as skipped under the preferred name
+}
+
+// Function to run one implementation on an input file and compare its printed mean,
+// median and mode frequency with the reference (ties for the mode are broken
+// differently by each implementation, so the value is compared only for one mode)
+static void compareLanguage(const char *name, const char *command, const char *inputPath,
+                            Distribution dist, size_t n, const Reference *ref) {
+    const char *outputPath = "stats_bench_output.txt";
+    char line[512];
+    snprintf(line, sizeof(line), "%s < %s > %s", command, inputPath, outputPath);
+    fflush(stdout);     // Keep the table ahead of anything the command prints
+    if (system(line) != 0) {
+        printf("%-12s %12zu %-8s skipped (%s failed)\n", DIST_NAMES[dist], n, name, command);
+        remove(outputPath);
+        return;
+    }
+
+    FILE *file = fopen(outputPath, "rb");
+    char *output = NULL;
+    long size = 0;
+    if (file != NULL && fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) >= 0) {
+        output = (char *)malloc((size_t)size + 1);
+        rewind(file);
+        if (output != NULL) {
+            output[fread(output, 1, (size_t)size, file)] = '\0';
+        }
+    }
+    if (file != NULL) {
+        fclose(file);
+    }
+    remove(outputPath);
+    if (output == NULL) {
+        printf("%-12s %12zu %-8s skipped (no output)\n", DIST_NAMES[dist], n, name);
+        return;
+    }
+
+    // Both print two decimals, as does the C calculator
+    char expectedMean[64], expectedMedian[64], mean[64] = "", median[64] = "";
+    int mode = 0, frequency = 0;
+    snprintf(expectedMean, sizeof(expectedMean), "%.2f", ref->mean);
+    snprintf(expectedMedian, sizeof(expectedMedian), "%.2f", ref->median);
+    int ok = findValue(output, "Mean (Average): ", "%63s", mean)
+          && findValue(output, "Median (Middle Value): ", "%63s", median)
+          && findValue(output, "Mode (Most Frequent): ", "%d", &mode)
+          && findValue(strstr(output, "Mode (Most Frequent): "), "(appears ", "%d", &frequency);
+    ok = ok && strcmp(mean, expectedMean) == 0 && strcmp(median, expectedMedian) == 0
+            && frequency == ref->mode.frequency && (ref->mode.count > 1 || mode == ref->mode.value);
+    printf("%-12s %12zu %-8s %12s %12s %10s %10s  %s\n", DIST_NAMES[dist], n, name, "", "", "", "",
+           verdict(ok, 1));
+    if (!ok) {
+        printf("    expected mean %s, median %s, mode frequency %d; got %s, %s, %d\n",
+               expectedMean, expectedMedian, ref->mode.frequency, mean, median, frequency);
+    }
+    free(output);
+}
+
+// Function to write a dataset in the interactive input format of the Python and
+// OCaml calculators (count, then one value per line) and run both on it
+static void compareLanguages(const int *arr, size_t n, Distribution dist, const Reference *ref) {
+    const char *inputPath = "stats_bench_input.txt";
+    FILE *file = fopen(inputPath, "w");
+    if (file == NULL) {
+        printf("Cannot write %s\n", inputPath);
+        return;
+    }
+    fprintf(file, "%zu\n", n);
+    for (size_t i = 0; i < n; i++) {
+        fprintf(file, "%d\n", arr[i]);
+    }
+    fclose(file);
+
+    char python[64];
+    snprintf(python, sizeof(python), "%s statistics_calculator.py", pythonCommand());
+    compareLanguage("python", python, inputPath, dist, n, ref);
+    compareLanguage("ocaml", "ocaml statistics.ml", inputPath, dist, n, ref);
+    remove(inputPath);
+}
+
+int main(int argc, char *argv[]) {
+    long long maxN = DEFAULT_MAX_N;
+    int checking = 1;
+    int languages = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-check") == 0) {
+            checking = 0;
+        } else if (strcmp(argv[i], "--languages") == 0) {
+            languages = 1;
+        } else if (atoll(argv[i]) >= 1000 && atoll(argv[i]) <= MAX_N) {
+            maxN = atoll(argv[i]);
+        } else {
+            printf("Usage: %s [maxN (1000 to 1000000000)] [--no-check] [--languages]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    printf("=== Statistics Kernel Benchmarks ===\n\n");
+    printf("%-12s %12s %-8s %12s %12s %10s %10s  %s\n", "Data", "N", "Kernel", "ms/call",
+           "Melem/s", "MB/s", "PeakMB", "Check");
+
+    for (long long size = 1000; size <= maxN; size *= 10) {
+        size_t n = (size_t)size;
+        int *arr = (int *)malloc(n * sizeof(int));
+        int *work = (int *)malloc(n * sizeof(int));
+        if (arr == NULL || work == NULL) {
+            printf("n = %zu skipped: cannot allocate %.0f MB\n", n, 2.0 * n * sizeof(int) / 1e6);
+            free(arr);
+            free(work);
+            break;
+        }
+
+        for (int d = 0; d < DIST_COUNT; d++) {
+            Distribution dist = (Distribution)d;
+            Reference ref;
+            memset(&ref, 0, sizeof(ref));
+            generate(arr, n, dist);
+            if (checking) {
+                computeReference(arr, n, work, &ref);
+            }
+            benchmarkDataset(arr, n, dist, work, &ref, checking);
+            if (languages && n <= LANGUAGE_LIMIT) {
+                if (!checking) {
+                    computeReference(arr, n, work, &ref);
+                }
+                compareLanguages(arr, n, dist, &ref);
+            }
+        }
+        free(arr);
+        free(work);
+    }
+
+    printf("\n%s\n", failures == 0 ? "All results match the reference" : "MISMATCHES FOUND");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,296 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L // mmap and posix_madvise under -std=c99
+#endif
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stats_input.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define ONES 0x0101010101010101ULL
+#define HIGH_BITS 0x8080808080808080ULL
+
+// ---------------------------------------------------------------------------
+// Memory mapping
+// ---------------------------------------------------------------------------
+
+#ifdef _WIN32
+
+int mapInputFile(MappedInput *input, const char *path) {
+    memset(input, 0, sizeof(*input));
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        printf("Cannot open %s\n", path);
+        return -1;
+    }
+    input->fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        printf("Cannot read the size of %s\n", path);
+        unmapInputFile(input);
+        return -1;
+    }
+    input->size = (size_t)fileSize.QuadPart;
+    if (input->size == 0) {
+        return 0;
+    }
+
+    // Copy-on-write view: writes go to private pages, never to the file
+    input->mappingHandle = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (input->mappingHandle == NULL) {
+        printf("Cannot map %s\n", path);
+        unmapInputFile(input);
+        return -1;
+    }
+    input->data = (char *)MapViewOfFile(input->mappingHandle, FILE_MAP_COPY, 0, 0, 0);
+    if (input->data == NULL) {
+        printf("Cannot map %s\n", path);
+        unmapInputFile(input);
+        return -1;
+    }
+    return 0;
+}
+
+void unmapInputFile(MappedInput *input) {
+    if (input->data != NULL) {
+        UnmapViewOfFile(input->data);
+    }
+    if (input->mappingHandle != NULL) {
+        CloseHandle((HANDLE)input->mappingHandle);
+    }
+    if (input->fileHandle != NULL) {
+        CloseHandle((HANDLE)input->fileHandle);
+    }
+    memset(input, 0, sizeof(*input));
+}
+
+#else
+
+int mapInputFile(MappedInput *input, const char *path) {
+    memset(input, 0, sizeof(*input));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        printf("Cannot open %s\n", path);
+        return -1;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        printf("Cannot read the size of %s\n", path);
+        close(fd);
+        return -1;
+    }
+    input->size = (size_t)info.st_size;
+    if (input->size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    // Copy-on-write view: writes go to private pages, never to the file
+    void *mapping = mmap(NULL, input->size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file referenced
+    if (mapping == MAP_FAILED) {
+        printf("Cannot map %s\n", path);
+        input->size = 0;
+        return -1;
+    }
+    posix_madvise(mapping, input->size, POSIX_MADV_SEQUENTIAL);
+    input->data = (char *)mapping;
+    return 0;
+}
+
+void unmapInputFile(MappedInput *input) {
+    if (input->data != NULL) {
+        munmap(input->data, input->size);
+    }
+    memset(input, 0, sizeof(*input));
+}
+
+#endif
+
+// ---------------------------------------------------------------------------
+// Text parsing
+// ---------------------------------------------------------------------------
+
+// Characters allowed between numbers: whitespace, ',' and ';'
+static const unsigned char SEPARATORS[256] = {
+    ['\t'] = 1, ['\n'] = 1, ['\r'] = 1, [' '] = 1, [','] = 1, [';'] = 1
+};
+
+#define OUT_OF_RANGE ((unsigned long long)INT_MAX + 2)
+
+// Function to load 8 bytes as a little-endian word
+static unsigned long long loadWord(const char *p) {
+    unsigned long long word;
+    memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// Function to test whether all 8 bytes of a word XORed with '0' were digits. The XOR
+// maps digits to 0-9 and every other byte to 10 or more; adding 0x76 then sets the
+// high bit of exactly the non-digit bytes.
+static int allDigits(unsigned long long digits) {
+    return ((((digits & ~HIGH_BITS) + 0x76 * ONES) | digits) & HIGH_BITS) == 0;
+}
+
+// Function to convert 8 digits (first digit in the lowest byte) with two multiplies:
+// neighbouring digits are combined into 2-, then 4-, then 8-digit lanes
+static unsigned long long convertEightDigits(unsigned long long digits) {
+    digits = (digits * 10 + (digits >> 8)) & 0x00FF00FF00FF00FFULL;
+    digits = (digits * 100 + (digits >> 16)) & 0x0000FFFF0000FFFFULL;
+    return (digits * 10000 + (digits >> 32)) & 0xFFFFFFFFULL;
+}
+
+int parseIntegers(const char *text, size_t size, int **values, size_t *count) {
+    *values = NULL;
+    *count = 0;
+    if (!text && size > 0) {
+        printf("Invalid arguments\n");
+        return -1;
+    }
+
+    // Grown by doubling; a first guess of one number per 8 bytes avoids most regrowth
+    size_t capacity = size / 8 + 16;
+    int *out = (int *)malloc(capacity * sizeof(int));
+    if (out == NULL) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+
+    size_t n = 0;
+    size_t pos = 0;
+    for (;;) {
+        while (pos < size && SEPARATORS[(unsigned char)text[pos]]) {
+            pos++;
+        }
+        if (pos == size) {
+            break;
+        }
+
+        size_t start = pos;
+        int negative = text[pos] == '-';
+        pos += (size_t)(negative | (text[pos] == '+'));
+        size_t firstDigit = pos;
+
+        // Eight digits per step while they last, then the rest one at a time
+        unsigned long long magnitude = 0;
+        while (size - pos >= 8) {
+            unsigned long long digits = loadWord(text + pos) ^ (0x30 * ONES);
+            if (!allDigits(digits)) {
+                break;
+            }
+            magnitude = magnitude * 100000000ULL + convertEightDigits(digits);
+            magnitude = magnitude > OUT_OF_RANGE ? OUT_OF_RANGE : magnitude;
+            pos += 8;
+        }
+        while (pos < size && (unsigned char)(text[pos] - '0') < 10) {
+            magnitude = magnitude * 10 + (unsigned long long)(text[pos] - '0');
+            pos++;
+        }
+
+        if (pos == firstDigit || (pos < size && !SEPARATORS[(unsigned char)text[pos]])) {
+            printf("Invalid number at byte %zu\n", start);
+            free(out);
+            return -1;
+        }
+        if (magnitude > (unsigned long long)INT_MAX + (unsigned long long)negative) {
+            printf("Number out of range at byte %zu\n", start);
+            free(out);
+            return -1;
+        }
+
+        if (n == capacity) {
+            capacity *= 2;
+            int *grown = (int *)realloc(out, capacity * sizeof(int));
+            if (grown == NULL) {
+                printf("Memory allocation failed\n");
+                free(out);
+                return -1;
+            }
+            out = grown;
+        }
+        out[n++] = negative ? (int)(-(long long)magnitude) : (int)magnitude;
+    }
+
+    *values = out;
+    *count = n;
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// Datasets
+// ---------------------------------------------------------------------------
+
+int loadIntDataset(IntDataset *dataset, const char *path, InputFormat format) {
+    memset(dataset, 0, sizeof(*dataset));
+    if (mapInputFile(&dataset->file, path) != 0) {
+        return -1;
+    }
+    const char *data = dataset->file.data;
+    size_t size = dataset->file.size;
+
+    if (format == INPUT_INT32) {
+        if (size % sizeof(int) != 0) {
+            printf("%s is not a whole number of 32-bit integers\n", path);
+            return -1;
+        }
+        // The mapping is page-aligned, so the ints are used where they lie
+        dataset->values = (int *)dataset->file.data;
+        dataset->count = size / sizeof(int);
+        return 0;
+    }
+
+    if (format == INPUT_INT64) {
+        if (size % sizeof(long long) != 0) {
+            printf("%s is not a whole number of 64-bit integers\n", path);
+            return -1;
+        }
+        // The statistics work on int, so 64-bit input is narrowed into a new array
+        const long long *wide = (const long long *)data;
+        size_t count = size / sizeof(long long);
+        dataset->values = (int *)malloc((count > 0 ? count : 1) * sizeof(int));
+        if (dataset->values == NULL) {
+            printf("Memory allocation failed\n");
+            return -1;
+        }
+        dataset->ownsValues = 1;
+        for (size_t i = 0; i < count; i++) {
+            if (wide[i] < INT_MIN || wide[i] > INT_MAX) {
+                printf("Value %lld at element %zu does not fit in an int\n", wide[i], i);
+                return -1;
+            }
+            dataset->values[i] = (int)wide[i];
+        }
+        dataset->count = count;
+        return 0;
+    }
+
+    if (parseIntegers(data, size, &dataset->values, &dataset->count) != 0) {
+        return -1;
+    }
+    dataset->ownsValues = 1;
+    return 0;
+}
+
+void freeIntDataset(IntDataset *dataset) {
+    if (dataset->ownsValues) {
+        free(dataset->values);
+    }
+    unmapInputFile(&dataset->file);
+    memset(dataset, 0, sizeof(*dataset));
+}
@@ -0,0 +1,46 @@
+#ifndef STATS_INPUT_H
+#define STATS_INPUT_H
+
+#include <stddef.h>
+
+// File input for the statistics tool. Files are memory-mapped copy-on-write: the
+// data is paged in straight from the page cache, and functions that reorder their
+// input (calculateMedian) only copy the pages they actually write to. The file on
+// disk is never modified.
+
+typedef enum {
+    INPUT_TEXT,     // Decimal integers separated by whitespace, commas or semicolons
+    INPUT_INT32,    // Raw native-endian 32-bit integers: used in place, zero copy
+    INPUT_INT64     // Raw native-endian 64-bit integers: narrowed to int on load
+} InputFormat;
+
+typedef struct {
+    char *data;     // NULL for an empty file
+    size_t size;
+#ifdef _WIN32
+    void *fileHandle;
+    void *mappingHandle;
+#endif
+} MappedInput;
+
+typedef struct {
+    MappedInput file;
+    int *values;    // Inside file.data for INPUT_INT32, otherwise allocated
+    size_t count;
+    int ownsValues;
+} IntDataset;
+
+// Function to map a whole file; returns 0, or -1 on error
+int mapInputFile(MappedInput *input, const char *path);
+void unmapInputFile(MappedInput *input);
+
+// Function to parse every integer in text. Returns 0 and stores a malloc'd array
+// (free it with free()) and its length, or -1 on a malformed or out-of-range number.
+int parseIntegers(const char *text, size_t size, int **values, size_t *count);
+
+// Function to load a dataset in the given format; returns 0, or -1 on error.
+// Release it with freeIntDataset() either way.
+int loadIntDataset(IntDataset *dataset, const char *path, InputFormat format);
+void freeIntDataset(IntDataset *dataset);
+
+#endif // STATS_INPUT_H
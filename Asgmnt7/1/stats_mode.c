@@ -0,0 +1,386 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stats_mode.h"
+
+#define DIRECT_MAX_RANGE ((size_t)1 << 26)  // 256 MB of counters at most
+#define HASH_MAX_CAPACITY ((size_t)1 << 22) // Beyond this, radix sort is faster
+#define RADIX_BITS 11
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+
+// Function to map a value to a table slot. The MurmurHash3 finalizer mixes every key
+// bit into the low bits, so arithmetic progressions of keys do not cluster.
+static size_t hashSlot(int key, size_t mask) {
+    unsigned int h = (unsigned int)key;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return (size_t)h & mask;
+}
+
+// Function to move the hash table into a table of twice the capacity
+static int growHashTable(FrequencyTable *table) {
+    size_t capacity = table->capacity * 2;
+    FrequencyEntry *entries = (FrequencyEntry *)calloc(capacity, sizeof(FrequencyEntry));
+    if (entries == NULL) {
+        return -1;
+    }
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->table[i].count > 0) {
+            size_t slot = hashSlot(table->table[i].key, capacity - 1);
+            while (entries[slot].count > 0) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            entries[slot] = table->table[i];
+        }
+    }
+    free(table->table);
+    table->table = entries;
+    table->capacity = capacity;
+    return 0;
+}
+
+// Function to count with a hash table; returns 1 if the table outgrew
+// HASH_MAX_CAPACITY (the caller switches strategy), 0 on success, -1 on error
+static int countWithHash(FrequencyTable *table, const int *arr, size_t n) {
+    table->capacity = 1024;
+    table->table = (FrequencyEntry *)calloc(table->capacity, sizeof(FrequencyEntry));
+    if (table->table == NULL) {
+        return -1;
+    }
+
+    // Locals keep the hot loop free of reloads through table
+    FrequencyEntry *entries = table->table;
+    size_t mask = table->capacity - 1;
+    size_t distinct = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        int key = arr[i];
+        size_t slot = hashSlot(key, mask);
+        while (entries[slot].count > 0 && entries[slot].key != key) {
+            slot = (slot + 1) & mask;
+        }
+        if (entries[slot].count == 0) {
+            entries[slot].key = key;
+            // Keep the load factor at or below 1/2
+            if (++distinct * 2 > mask + 1) {
+                entries[slot].count = 1;
+                table->distinct = distinct;
+                if (table->capacity >= HASH_MAX_CAPACITY) {
+                    return 1;
+                }
+                if (growHashTable(table) != 0) {
+                    return -1;
+                }
+                entries = table->table;
+                mask = table->capacity - 1;
+                continue;
+            }
+        }
+        entries[slot].count++;
+    }
+    table->distinct = distinct;
+    return 0;
+}
+
+// Function to sort a copy of arr with an LSD radix sort on the sign-flipped bits,
+// skipping passes whose digit is the same for every element
+static int countWithRadix(FrequencyTable *table, const int *arr, size_t n) {
+    unsigned int *keys = (unsigned int *)malloc(n * sizeof(unsigned int));
+    unsigned int *buffer = (unsigned int *)malloc(n * sizeof(unsigned int));
+    size_t *counts = (size_t *)malloc(RADIX_BUCKETS * sizeof(size_t));
+    if (keys == NULL || buffer == NULL || counts == NULL) {
+        free(keys);
+        free(buffer);
+        free(counts);
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = (unsigned int)arr[i] ^ 0x80000000u; // Signed order as unsigned order
+    }
+
+    for (int shift = 0; shift < 32; shift += RADIX_BITS) {
+        memset(counts, 0, RADIX_BUCKETS * sizeof(size_t));
+        for (size_t i = 0; i < n; i++) {
+            counts[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++;
+        }
+        if (counts[(keys[0] >> shift) & (RADIX_BUCKETS - 1)] == n) {
+            continue; // Every element has the same digit
+        }
+
+        size_t offset = 0;
+        for (int b = 0; b < RADIX_BUCKETS; b++) {
+            size_t count = counts[b];
+            counts[b] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < n; i++) {
+            buffer[counts[(keys[i] >> shift) & (RADIX_BUCKETS - 1)]++] = keys[i];
+        }
+        unsigned int *swap = keys;
+        keys = buffer;
+        buffer = swap;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        keys[i] ^= 0x80000000u;
+    }
+    free(buffer);
+    free(counts);
+    table->sorted = (int *)keys;
+    return 0;
+}
+
+int buildFrequencyTable(FrequencyTable *table, const int *arr, size_t n) {
+    if (!table) {
+        printf("Invalid arguments\n");
+        return -1;
+    }
+    memset(table, 0, sizeof(*table));
+    if (n == 0 || !arr) {
+        printf("Array is empty\n");
+        return -1;
+    }
+    table->n = n;
+
+    int minValue = arr[0];
+    int maxValue = arr[0];
+    for (size_t i = 1; i < n; i++) {
+        minValue = arr[i] < minValue ? arr[i] : minValue;
+        maxValue = arr[i] > maxValue ? arr[i] : maxValue;
+    }
+    // 64-bit: the full int range has 2^32 values, which would wrap a 32-bit size_t to 0
+    unsigned long long range = (unsigned long long)((long long)maxValue - (long long)minValue) + 1;
+
+    // Small range: one counter per value is the cheapest possible histogram
+    if (range <= (unsigned long long)n + 65536 && range <= DIRECT_MAX_RANGE && n <= UINT_MAX) {
+        table->strategy = FREQ_DIRECT;
+        table->minValue = minValue;
+        table->range = (size_t)range;
+        table->direct = (unsigned int *)calloc(table->range, sizeof(unsigned int));
+        if (table->direct == NULL) {
+            printf("Memory allocation failed\n");
+            return -1;
+        }
+        for (size_t i = 0; i < n; i++) {
+            table->direct[(size_t)((long long)arr[i] - minValue)]++;
+        }
+        return 0;
+    }
+
+    table->strategy = FREQ_HASH;
+    int status = countWithHash(table, arr, n);
+    if (status == 1) {
+        // Too many distinct values for the hash table to stay in cache
+        free(table->table);
+        table->table = NULL;
+        table->capacity = 0;
+        table->distinct = 0;
+        table->strategy = FREQ_RADIX;
+        status = countWithRadix(table, arr, n);
+    }
+    if (status != 0) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+    return 0;
+}
+
+void freeFrequencyTable(FrequencyTable *table) {
+    if (!table) {
+        return;
+    }
+    free(table->direct);
+    free(table->table);
+    free(table->sorted);
+    memset(table, 0, sizeof(*table));
+}
+
+// Callback invoked once per distinct value
+typedef void (*CountVisitor)(int value, size_t count, void *context);
+
+// Function to visit every (value, count) pair; direct and radix tables visit in
+// ascending value order, hash tables in slot order
+static void visitCounts(const FrequencyTable *table, CountVisitor visit, void *context) {
+    if (table->strategy == FREQ_DIRECT) {
+        for (size_t i = 0; i < table->range; i++) {
+            if (table->direct[i] > 0) {
+                visit((int)((long long)table->minValue + (long long)i), table->direct[i], context);
+            }
+        }
+    } else if (table->strategy == FREQ_HASH) {
+        for (size_t i = 0; i < table->capacity; i++) {
+            if (table->table[i].count > 0) {
+                visit(table->table[i].key, table->table[i].count, context);
+            }
+        }
+    } else if (table->sorted != NULL) {
+        size_t start = 0;
+        for (size_t i = 1; i <= table->n; i++) {
+            if (i == table->n || table->sorted[i] != table->sorted[start]) {
+                visit(table->sorted[start], i - start, context);
+                start = i;
+            }
+        }
+    }
+}
+
+typedef struct {
+    size_t best;
+    size_t modeCount;
+    int *modes;
+    size_t maxModes;
+} ModeScan;
+
+static void scanMaxFrequency(int value, size_t count, void *context) {
+    ModeScan *scan = (ModeScan *)context;
+    (void)value;
+    if (count > scan->best) {
+        scan->best = count;
+    }
+}
+
+// Function to restore the max-heap property below index i
+static void siftDownMax(int *heap, size_t size, size_t i) {
+    for (;;) {
+        size_t largest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < size && heap[left] > heap[largest]) {
+            largest = left;
+        }
+        if (right < size && heap[right] > heap[largest]) {
+            largest = right;
+        }
+        if (largest == i) {
+            return;
+        }
+        int temp = heap[i];
+        heap[i] = heap[largest];
+        heap[largest] = temp;
+        i = largest;
+    }
+}
+
+// Keeps the maxModes smallest modes in a max-heap, whatever order they arrive in
+static void collectModes(int value, size_t count, void *context) {
+    ModeScan *scan = (ModeScan *)context;
+    if (count != scan->best) {
+        return;
+    }
+    size_t kept = scan->modeCount < scan->maxModes ? scan->modeCount : scan->maxModes;
+    scan->modeCount++;
+
+    if (kept < scan->maxModes) {
+        size_t i = kept;
+        while (i > 0 && scan->modes[(i - 1) / 2] < value) {
+            scan->modes[i] = scan->modes[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        scan->modes[i] = value;
+    } else if (kept > 0 && value < scan->modes[0]) {
+        scan->modes[0] = value;
+        siftDownMax(scan->modes, kept, 0);
+    }
+}
+
+size_t findModes(const FrequencyTable *table, int *modes, size_t maxModes, size_t *frequency) {
+    if (!table || table->n == 0 || (!modes && maxModes > 0)) {
+        printf("Invalid arguments\n");
+        return 0;
+    }
+
+    // Two passes over the distinct values: find the top frequency, then collect
+    ModeScan scan = { 0, 0, modes, maxModes };
+    visitCounts(table, scanMaxFrequency, &scan);
+    visitCounts(table, collectModes, &scan);
+
+    // Heap sort the kept modes into ascending order
+    size_t written = scan.modeCount < maxModes ? scan.modeCount : maxModes;
+    for (size_t end = written; end > 1; end--) {
+        int temp = modes[0];
+        modes[0] = modes[end - 1];
+        modes[end - 1] = temp;
+        siftDownMax(modes, end - 1, 0);
+    }
+    if (frequency) {
+        *frequency = scan.best;
+    }
+    return scan.modeCount;
+}
+
+typedef struct {
+    ValueCount *heap;   // Min-heap on (frequency, -value): the root is the weakest entry
+    size_t size;
+    size_t k;
+} TopScan;
+
+// Function to tell whether a ranks below b (lower frequency, or equal and larger value)
+static int weaker(const ValueCount *a, const ValueCount *b) {
+    return a->frequency < b->frequency || (a->frequency == b->frequency && a->value > b->value);
+}
+
+static void siftDown(ValueCount *heap, size_t size, size_t i) {
+    for (;;) {
+        size_t smallest = i;
+        size_t left = 2 * i + 1;
+        size_t right = left + 1;
+        if (left < size && weaker(&heap[left], &heap[smallest])) {
+            smallest = left;
+        }
+        if (right < size && weaker(&heap[right], &heap[smallest])) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            return;
+        }
+        ValueCount temp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = temp;
+        i = smallest;
+    }
+}
+
+static void offerTop(int value, size_t count, void *context) {
+    TopScan *scan = (TopScan *)context;
+    ValueCount entry;
+    entry.value = value;
+    entry.frequency = count;
+
+    if (scan->size < scan->k) {
+        // Sift up
+        size_t i = scan->size++;
+        while (i > 0 && weaker(&entry, &scan->heap[(i - 1) / 2])) {
+            scan->heap[i] = scan->heap[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        scan->heap[i] = entry;
+    } else if (weaker(&scan->heap[0], &entry)) {
+        scan->heap[0] = entry;
+        siftDown(scan->heap, scan->size, 0);
+    }
+}
+
+size_t topFrequencies(const FrequencyTable *table, ValueCount *out, size_t k) {
+    if (!table || table->n == 0 || (!out && k > 0)) {
+        printf("Invalid arguments\n");
+        return 0;
+    }
+
+    TopScan scan = { out, 0, k };
+    if (k > 0) {
+        visitCounts(table, offerTop, &scan);
+    }
+
+    // Pop the heap from the back to list the strongest entry first
+    for (size_t end = scan.size; end > 1; end--) {
+        ValueCount temp = out[0];
+        out[0] = out[end - 1];
+        out[end - 1] = temp;
+        siftDown(out, end - 1, 0);
+    }
+    return scan.size;
+}
@@ -0,0 +1,60 @@
+#ifndef STATS_MODE_H
+#define STATS_MODE_H
+
+#include <stddef.h>
+
+// Frequency counting for integer data in O(n). The strategy follows the data:
+//   FREQ_DIRECT  value range no larger than about n: one counter per possible value
+//   FREQ_HASH    few distinct values: open-addressing hash histogram
+//   FREQ_RADIX   many distinct values over a wide range: LSD radix sort, then runs
+// The hash table is tried first and abandoned for radix sort once it grows past what
+// stays cache-friendly, so the choice needs no up-front guess at the distinct count.
+
+typedef enum {
+    FREQ_DIRECT,
+    FREQ_HASH,
+    FREQ_RADIX
+} FrequencyStrategy;
+
+typedef struct {
+    int value;
+    size_t frequency;
+} ValueCount;
+
+typedef struct {
+    int key;
+    size_t count;   // 0 marks an empty slot
+} FrequencyEntry;
+
+typedef struct {
+    FrequencyStrategy strategy;
+    size_t n;
+
+    // FREQ_DIRECT
+    int minValue;
+    size_t range;
+    unsigned int *direct;
+
+    // FREQ_HASH
+    FrequencyEntry *table;
+    size_t capacity;
+    size_t distinct;
+
+    // FREQ_RADIX
+    int *sorted;
+} FrequencyTable;
+
+// Function to count every value of arr (arr is not modified). Returns 0, or -1 on
+// error; free the table with freeFrequencyTable() either way.
+int buildFrequencyTable(FrequencyTable *table, const int *arr, size_t n);
+void freeFrequencyTable(FrequencyTable *table);
+
+// Function to list the modes in ascending order. Writes up to maxModes of them,
+// stores their frequency and returns how many modes there are in total.
+size_t findModes(const FrequencyTable *table, int *modes, size_t maxModes, size_t *frequency);
+
+// Function to list the k most frequent values, most frequent first (ties: smaller
+// value first). Returns the number written, at most k.
+size_t topFrequencies(const FrequencyTable *table, ValueCount *out, size_t k);
+
+#endif // STATS_MODE_H
@@ -0,0 +1,918 @@
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stats_parallel.h"
+#include "stats_simd.h"
+#include "stats_mode.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#define SELECT_BITS 16
+#define SELECT_BUCKETS ((size_t)1 << SELECT_BITS)
+#define DIRECT_MODE_RANGE ((size_t)1 << 20)   // Per-thread counting arrays up to 8 MB
+#define MODE_PARTITION_BITS 10
+#define MODE_PARTITIONS ((size_t)1 << MODE_PARTITION_BITS)
+#define MODE_SCRATCH_BITS 18              // Per-thread partition counters up to 1 MB
+#define RADIX_DIGIT_BITS 11
+#define MODE_SORT_LIMIT ((size_t)1 << 22) // Per-thread partition sort buffers up to 16 MB
+
+// ---------------------------------------------------------------------------
+// Worker threads
+// ---------------------------------------------------------------------------
+
+// Work on elements [begin, end) of chunk number chunk, by worker number worker
+typedef void (*ChunkWork)(void *context, int worker, size_t chunk, size_t begin, size_t end);
+
+typedef struct {
+    ChunkWork work;
+    void *context;
+    size_t n;
+    size_t chunkSize;
+    size_t chunks;
+    volatile long nextChunk;
+} ParallelJob;
+
+typedef struct {
+    ParallelJob *job;
+    int worker;
+} WorkerArgs;
+
+// Function to claim the next chunk number
+static long claimChunk(volatile long *counter) {
+#ifdef _WIN32
+    return InterlockedIncrement(counter) - 1;
+#else
+    return __sync_fetch_and_add(counter, 1);
+#endif
+}
+
+static void runWorker(WorkerArgs *args) {
+    ParallelJob *job = args->job;
+    for (;;) {
+        long chunk = claimChunk(&job->nextChunk);
+        if (chunk < 0 || (size_t)chunk >= job->chunks) {
+            return;
+        }
+        size_t begin = (size_t)chunk * job->chunkSize;
+        size_t end = begin + job->chunkSize < job->n ? begin + job->chunkSize : job->n;
+        job->work(job->context, args->worker, (size_t)chunk, begin, end);
+    }
+}
+
+// Persistent worker threads, started on first use and reused by every later job, so
+// a median (up to five parallel passes) or a mode (four) does not create and join
+// threads per pass. Workers sleep on a condition variable between jobs and live until
+// the process exits; concurrent callers take turns.
+#ifdef _WIN32
+typedef SRWLOCK PoolLock;
+typedef CONDITION_VARIABLE PoolCondition;
+#define POOL_LOCK_INIT SRWLOCK_INIT
+#define POOL_CONDITION_INIT CONDITION_VARIABLE_INIT
+#else
+typedef pthread_mutex_t PoolLock;
+typedef pthread_cond_t PoolCondition;
+#define POOL_LOCK_INIT PTHREAD_MUTEX_INITIALIZER
+#define POOL_CONDITION_INIT PTHREAD_COND_INITIALIZER
+#endif
+
+typedef struct {
+    PoolLock runLock;           // Held for a whole job: one job at a time
+    PoolLock lock;              // Guards everything below
+    PoolCondition wake;         // A new job was published
+    PoolCondition done;         // The last helper finished
+    int started;                // Worker threads 1..started exist
+    int active;                 // Workers 1..active take part in the current job
+    int pending;                // Active workers still running it
+    unsigned long generation;   // Bumped for every job
+    ParallelJob *job;
+} WorkerPool;
+
+typedef struct {
+    int worker;
+    unsigned long generation;   // Last job published before the thread was created
+} WorkerStart;
+
+static WorkerPool pool = { POOL_LOCK_INIT, POOL_LOCK_INIT, POOL_CONDITION_INIT, POOL_CONDITION_INIT, 0, 0, 0, 0, NULL };
+
+static void lockPool(PoolLock *lock) {
+#ifdef _WIN32
+    AcquireSRWLockExclusive(lock);
+#else
+    pthread_mutex_lock(lock);
+#endif
+}
+
+static void unlockPool(PoolLock *lock) {
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(lock);
+#else
+    pthread_mutex_unlock(lock);
+#endif
+}
+
+static void waitPool(PoolCondition *condition, PoolLock *lock) {
+#ifdef _WIN32
+    SleepConditionVariableSRW(condition, lock, INFINITE, 0);
+#else
+    pthread_cond_wait(condition, lock);
+#endif
+}
+
+static void wakePool(PoolCondition *condition) {
+#ifdef _WIN32
+    WakeAllConditionVariable(condition);
+#else
+    pthread_cond_broadcast(condition);
+#endif
+}
+
+// Function to serve jobs forever as worker number start->worker
+static void poolWorker(WorkerStart *start) {
+    int worker = start->worker;
+    unsigned long seen = start->generation;
+    free(start);
+
+    lockPool(&pool.lock);
+    for (;;) {
+        while (pool.generation == seen) {
+            waitPool(&pool.wake, &pool.lock);
+        }
+        seen = pool.generation;
+        if (worker > pool.active) {
+            continue; // Not needed for this job
+        }
+        WorkerArgs args;
+        args.job = pool.job;
+        args.worker = worker;
+        unlockPool(&pool.lock);
+        runWorker(&args);
+        lockPool(&pool.lock);
+        if (--pool.pending == 0) {
+            wakePool(&pool.done);
+        }
+    }
+}
+
+#ifdef _WIN32
+static unsigned __stdcall workerMain(void *arg) {
+    poolWorker((WorkerStart *)arg);
+    return 0;
+}
+#else
+static void *workerMain(void *arg) {
+    poolWorker((WorkerStart *)arg);
+    return NULL;
+}
+#endif
+
+// Function to start pool workers until there are helpers of them (caller holds
+// runLock); returns how many exist, fewer if threads cannot be created
+static int ensureWorkers(int helpers) {
+    while (pool.started < helpers) {
+        WorkerStart *start = (WorkerStart *)malloc(sizeof(WorkerStart));
+        if (start == NULL) {
+            break;
+        }
+        start->worker = pool.started + 1;
+        start->generation = pool.generation;
+#ifdef _WIN32
+        HANDLE handle = (HANDLE)_beginthreadex(NULL, 0, workerMain, start, 0, NULL);
+        if (handle == 0) {
+            free(start);
+            break;
+        }
+        CloseHandle(handle);
+#else
+        pthread_t handle;
+        if (pthread_create(&handle, NULL, workerMain, start) != 0) {
+            free(start);
+            break;
+        }
+        pthread_detach(handle);
+#endif
+        pool.started++;
+    }
+    return pool.started < helpers ? pool.started : helpers;
+}
+
+int cpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+// Function to resolve the thread count for n elements: never more threads than chunks
+static int threadsFor(int threads, size_t n, size_t chunkSize) {
+    size_t chunks = (n + chunkSize - 1) / chunkSize;
+    if (threads <= 0) {
+        threads = cpuCount();
+    }
+    if ((size_t)threads > chunks) {
+        threads = chunks > 0 ? (int)chunks : 1;
+    }
+    return threads;
+}
+
+// Function to run work over every chunk of [0, n) on threads workers; the calling
+// thread is worker 0 and pool workers 1..threads-1 help. Falls back to fewer workers
+// if threads cannot be created.
+static void runParallel(int threads, size_t n, size_t chunkSize, ChunkWork work, void *context) {
+    ParallelJob job;
+    job.work = work;
+    job.context = context;
+    job.n = n;
+    job.chunkSize = chunkSize;
+    job.chunks = (n + chunkSize - 1) / chunkSize;
+    job.nextChunk = 0;
+
+    WorkerArgs self;
+    self.job = &job;
+    self.worker = 0;
+    if (threads <= 1) {
+        runWorker(&self);
+        return;
+    }
+
+    lockPool(&pool.runLock);
+    int helpers = ensureWorkers(threads - 1);
+    lockPool(&pool.lock);
+    pool.job = &job;
+    pool.active = helpers;
+    pool.pending = helpers;
+    pool.generation++;
+    wakePool(&pool.wake);
+    unlockPool(&pool.lock);
+
+    runWorker(&self);
+
+    lockPool(&pool.lock);
+    while (pool.pending > 0) {
+        waitPool(&pool.done, &pool.lock);
+    }
+    unlockPool(&pool.lock);
+    unlockPool(&pool.runLock);
+}
+
+// ---------------------------------------------------------------------------
+// Mean and variance
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const int *arr;
+    int squares;
+    long long *sums;        // Per worker
+    Wide128 *squareSums;    // Per worker
+} MomentJob;
+
+static void momentChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    MomentJob *job = (MomentJob *)context;
+    (void)chunk;
+    job->sums[worker] += sumInts(job->arr + begin, end - begin);
+    if (job->squares) {
+        job->squareSums[worker] = addWide128(job->squareSums[worker], sumSquaresInts(job->arr + begin, end - begin));
+    }
+}
+
+// Function to compute sum(x) and optionally sum(x^2) in parallel; returns -1 on error
+static int parallelMoments(const int *arr, size_t n, int threads, long long *sum, Wide128 *squares) {
+    threads = threadsFor(threads, n, PARALLEL_CHUNK);
+    getSimdLevel(); // Pick the kernels before any worker uses them
+
+    MomentJob job;
+    job.arr = arr;
+    job.squares = squares != NULL;
+    job.sums = (long long *)calloc((size_t)threads, sizeof(long long));
+    job.squareSums = (Wide128 *)calloc((size_t)threads, sizeof(Wide128));
+    if (job.sums == NULL || job.squareSums == NULL) {
+        printf("Memory allocation failed\n");
+        free(job.sums);
+        free(job.squareSums);
+        return -1;
+    }
+    runParallel(threads, n, PARALLEL_CHUNK, momentChunk, &job);
+
+    *sum = 0;
+    Wide128 total = {0, 0};
+    for (int t = 0; t < threads; t++) {
+        *sum += job.sums[t];
+        total = addWide128(total, job.squareSums[t]);
+    }
+    if (squares) {
+        *squares = total;
+    }
+    free(job.sums);
+    free(job.squareSums);
+    return 0;
+}
+
+double parallelMean(const int *arr, size_t n, int threads) {
+    if (n == 0 || !arr) {
+        printf("Num of elements is 0\n");
+        return 0.0;
+    }
+    long long sum = 0;
+    if (parallelMoments(arr, n, threads, &sum, NULL) != 0) {
+        return 0.0;
+    }
+    return (double)sum / (double)n;
+}
+
+double parallelVariance(const int *arr, size_t n, int threads) {
+    if (n < 2 || !arr) {
+        return 0.0;
+    }
+    long long sum = 0;
+    Wide128 squares;
+    if (parallelMoments(arr, n, threads, &sum, &squares) != 0) {
+        return 0.0;
+    }
+    return varianceFromSums(n, sum, squares);
+}
+
+// ---------------------------------------------------------------------------
+// Histograms
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const int *arr;
+    int low;
+    int binWidth;
+    size_t bins;
+    size_t *counts;         // bins per worker
+} HistogramJob;
+
+static void histogramChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    HistogramJob *job = (HistogramJob *)context;
+    (void)chunk;
+    histogramInts(job->arr + begin, end - begin, job->low, job->binWidth, job->bins, job->counts + (size_t)worker * job->bins);
+}
+
+void parallelHistogram(const int *arr, size_t n, int threads, int low, int binWidth, size_t bins, size_t *counts) {
+    if ((!arr && n > 0) || !counts || bins == 0 || binWidth <= 0) {
+        printf("Invalid arguments\n");
+        return;
+    }
+    threads = threadsFor(threads, n, PARALLEL_CHUNK);
+    getSimdLevel();
+
+    HistogramJob job;
+    job.arr = arr;
+    job.low = low;
+    job.binWidth = binWidth;
+    job.bins = bins;
+    job.counts = (size_t *)calloc((size_t)threads * bins, sizeof(size_t));
+    if (job.counts == NULL) {
+        printf("Memory allocation failed\n");
+        return;
+    }
+    runParallel(threads, n, PARALLEL_CHUNK, histogramChunk, &job);
+
+    for (int t = 0; t < threads; t++) {
+        for (size_t b = 0; b < bins; b++) {
+            counts[b] += job.counts[(size_t)t * bins + b];
+        }
+    }
+    free(job.counts);
+}
+
+// ---------------------------------------------------------------------------
+// Median: parallel radix selection
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const int *arr;
+    long long low;          // Current value range [low, high]
+    long long high;
+    int shift;              // Bucket = (x - low) >> shift
+    size_t *counts;         // SELECT_BUCKETS per worker
+    int *minAbove;          // Per worker: smallest value > low (successor search)
+    int *found;
+} SelectJob;
+
+static void minMaxChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    SelectJob *job = (SelectJob *)context;
+    int lo, hi;
+    (void)chunk;
+    minMaxInts(job->arr + begin, end - begin, &lo, &hi);
+    int *bounds = job->minAbove + 2 * (size_t)worker;
+    if (!job->found[worker] || lo < bounds[0]) {
+        bounds[0] = lo;
+    }
+    if (!job->found[worker] || hi > bounds[1]) {
+        bounds[1] = hi;
+    }
+    job->found[worker] = 1;
+}
+
+static void selectChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    SelectJob *job = (SelectJob *)context;
+    size_t *counts = job->counts + (size_t)worker * SELECT_BUCKETS;
+    long long low = job->low;
+    long long high = job->high;
+    int shift = job->shift;
+    (void)chunk;
+    for (size_t i = begin; i < end; i++) {
+        long long value = job->arr[i];
+        if (value >= low && value <= high) {
+            counts[(size_t)(value - low) >> shift]++;
+        }
+    }
+}
+
+static void successorChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    SelectJob *job = (SelectJob *)context;
+    int best = job->minAbove[worker];
+    int found = job->found[worker];
+    (void)chunk;
+    for (size_t i = begin; i < end; i++) {
+        int value = job->arr[i];
+        if (value > job->low && (!found || value < best)) {
+            best = value;
+            found = 1;
+        }
+    }
+    job->minAbove[worker] = best;
+    job->found[worker] = found;
+}
+
+// Function to select rank k; also reports how many elements are smaller than the
+// result (*below) and equal to it (*equal)
+static int radixSelect(const int *arr, size_t n, int threads, size_t k, size_t *below, size_t *equal) {
+    SelectJob job;
+    job.arr = arr;
+    job.counts = (size_t *)malloc((size_t)threads * SELECT_BUCKETS * sizeof(size_t));
+    job.minAbove = (int *)calloc(2 * (size_t)threads, sizeof(int));
+    job.found = (int *)calloc((size_t)threads, sizeof(int));
+    if (job.counts == NULL || job.minAbove == NULL || job.found == NULL) {
+        printf("Memory allocation failed\n");
+        free(job.counts);
+        free(job.minAbove);
+        free(job.found);
+        return 0;
+    }
+
+    // Start from the full value range of the data
+    runParallel(threads, n, PARALLEL_CHUNK, minMaxChunk, &job);
+    int lo = 0, hi = 0, any = 0;
+    for (int t = 0; t < threads; t++) {
+        if (job.found[t]) {
+            lo = !any || job.minAbove[2 * t] < lo ? job.minAbove[2 * t] : lo;
+            hi = !any || job.minAbove[2 * t + 1] > hi ? job.minAbove[2 * t + 1] : hi;
+            any = 1;
+        }
+    }
+    job.low = lo;
+    job.high = hi;
+    *below = 0;
+    *equal = n;
+
+    while (job.low < job.high) {
+        // Bucket width: the smallest power of two that fits the range in SELECT_BUCKETS
+        unsigned long long range = (unsigned long long)(job.high - job.low) + 1;
+        job.shift = 0;
+        while ((range - 1) >> job.shift >= SELECT_BUCKETS) {
+            job.shift++;
+        }
+        memset(job.counts, 0, (size_t)threads * SELECT_BUCKETS * sizeof(size_t));
+        runParallel(threads, n, PARALLEL_CHUNK, selectChunk, &job);
+
+        // Merge worker histograms in order and walk to the bucket holding rank k
+        size_t buckets = (size_t)((range - 1) >> job.shift) + 1;
+        size_t bucket = 0;
+        for (; bucket < buckets; bucket++) {
+            size_t count = 0;
+            for (int t = 0; t < threads; t++) {
+                count += job.counts[(size_t)t * SELECT_BUCKETS + bucket];
+            }
+            if (k < *below + count) {
+                *equal = count;
+                break;
+            }
+            *below += count;
+        }
+        long long bucketLow = job.low + ((long long)bucket << job.shift);
+        long long bucketHigh = bucketLow + ((long long)1 << job.shift) - 1;
+        job.low = bucketLow;
+        job.high = bucketHigh < job.high ? bucketHigh : job.high;
+    }
+
+    free(job.counts);
+    free(job.minAbove);
+    free(job.found);
+    return (int)job.low;
+}
+
+int parallelSelect(const int *arr, size_t n, int threads, size_t k) {
+    if (!arr || k >= n) {
+        printf("Invalid arguments\n");
+        return 0;
+    }
+    size_t below, equal;
+    return radixSelect(arr, n, threadsFor(threads, n, PARALLEL_CHUNK), k, &below, &equal);
+}
+
+double parallelMedian(const int *arr, size_t n, int threads) {
+    if (n == 0 || !arr) {
+        printf("Array is empty \n");
+        return 0.0;
+    }
+    threads = threadsFor(threads, n, PARALLEL_CHUNK);
+    getSimdLevel();
+
+    size_t below, equal;
+    int lower = radixSelect(arr, n, threads, (n - 1) / 2, &below, &equal);
+    if (n % 2 == 1 || n / 2 < below + equal) {
+        return (double)lower; // Odd n, or both middle ranks hold the same value
+    }
+
+    // The upper middle value is the smallest value above the lower one: one more pass
+    SelectJob job;
+    job.arr = arr;
+    job.low = lower;
+    job.minAbove = (int *)calloc((size_t)threads, sizeof(int));
+    job.found = (int *)calloc((size_t)threads, sizeof(int));
+    if (job.minAbove == NULL || job.found == NULL) {
+        printf("Memory allocation failed\n");
+        free(job.minAbove);
+        free(job.found);
+        return 0.0;
+    }
+    runParallel(threads, n, PARALLEL_CHUNK, successorChunk, &job);
+    int upper = lower;
+    int any = 0;
+    for (int t = 0; t < threads; t++) {
+        if (job.found[t] && (!any || job.minAbove[t] < upper)) {
+            upper = job.minAbove[t];
+            any = 1;
+        }
+    }
+    free(job.minAbove);
+    free(job.found);
+    return ((double)lower + (double)upper) / 2.0;
+}
+
+// ---------------------------------------------------------------------------
+// Modes
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const int *arr;
+    int minValue;
+    size_t range;
+    int shift;              // Partition = (x - minValue) >> shift
+    size_t *directCounts;   // range per worker (small ranges)
+    size_t *chunkCounts;    // MODE_PARTITIONS per chunk (wide ranges)
+    size_t *partitionStarts;
+    int *partitioned;       // Values grouped by partition
+    unsigned int *scratch;  // 2^shift counters per worker, all zero between partitions
+    int *sortBuffers;       // sortLimit values per worker, when partitions are sorted
+    size_t *radixCounts;    // 2^11 per worker
+    size_t sortLimit;
+    FrequencyTable *tables; // Partitions too big to sort in a worker buffer
+    size_t *partitionBest;  // Highest frequency in each partition
+    size_t *partitionModes; // Number of values reaching it
+    int *bounds;            // Per worker min/max
+    int *found;
+} ModeJob;
+
+// Function to pick the partition of a value: partitions are equal-width value ranges
+static size_t modePartition(const ModeJob *job, int value) {
+    return (size_t)((long long)value - job->minValue) >> job->shift;
+}
+
+static void modeBoundsChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    ModeJob *job = (ModeJob *)context;
+    int lo, hi;
+    (void)chunk;
+    minMaxInts(job->arr + begin, end - begin, &lo, &hi);
+    int *bounds = job->bounds + 2 * (size_t)worker;
+    if (!job->found[worker] || lo < bounds[0]) {
+        bounds[0] = lo;
+    }
+    if (!job->found[worker] || hi > bounds[1]) {
+        bounds[1] = hi;
+    }
+    job->found[worker] = 1;
+}
+
+static void directCountChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    ModeJob *job = (ModeJob *)context;
+    size_t *counts = job->directCounts + (size_t)worker * job->range;
+    (void)chunk;
+    for (size_t i = begin; i < end; i++) {
+        counts[(size_t)((long long)job->arr[i] - job->minValue)]++;
+    }
+}
+
+static void partitionCountChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    ModeJob *job = (ModeJob *)context;
+    size_t *counts = job->chunkCounts + chunk * MODE_PARTITIONS;
+    (void)worker;
+    for (size_t i = begin; i < end; i++) {
+        counts[modePartition(job, job->arr[i])]++;
+    }
+}
+
+static void partitionScatterChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    ModeJob *job = (ModeJob *)context;
+    size_t *offsets = job->chunkCounts + chunk * MODE_PARTITIONS; // Now write positions
+    (void)worker;
+    for (size_t i = begin; i < end; i++) {
+        job->partitioned[offsets[modePartition(job, job->arr[i])]++] = job->arr[i];
+    }
+}
+
+// Function to count partition p into the worker's scratch counters and find its
+// highest frequency and how many values reach it
+static void countPartition(const ModeJob *job, unsigned int *counts, size_t p, size_t *best, size_t *modeCount) {
+    long long base = (long long)job->minValue + ((long long)p << job->shift);
+    *best = 0;
+    *modeCount = 0;
+    for (size_t i = job->partitionStarts[p]; i < job->partitionStarts[p + 1]; i++) {
+        // Counts rise one at a time, so tracking the top while counting is exact
+        size_t count = ++counts[(size_t)((long long)job->partitioned[i] - base)];
+        if (count > *best) {
+            *best = count;
+            *modeCount = 0;
+        }
+        *modeCount += count == *best;
+    }
+}
+
+// Function to reset the counters touched by partition p; walking the values instead
+// of the whole counter array keeps sparse partitions cheap
+static void clearPartition(const ModeJob *job, unsigned int *counts, size_t p) {
+    long long base = (long long)job->minValue + ((long long)p << job->shift);
+    for (size_t i = job->partitionStarts[p]; i < job->partitionStarts[p + 1]; i++) {
+        counts[(size_t)((long long)job->partitioned[i] - base)] = 0;
+    }
+}
+
+// Function to sort partition p in place with two LSD radix passes over its low
+// shift bits (the bits above are the same for the whole partition)
+static void sortPartition(const ModeJob *job, int *buffer, size_t *counts, size_t p) {
+    int *values = job->partitioned + job->partitionStarts[p];
+    size_t count = job->partitionStarts[p + 1] - job->partitionStarts[p];
+    long long base = (long long)job->minValue + ((long long)p << job->shift);
+    int digitBits = (job->shift + 1) / 2;
+    size_t buckets = (size_t)1 << digitBits;
+
+    for (int pass = 0; pass < 2; pass++) {
+        int *from = pass == 0 ? values : buffer;
+        int *to = pass == 0 ? buffer : values;
+        int digitShift = pass * digitBits;
+        memset(counts, 0, buckets * sizeof(size_t));
+        for (size_t i = 0; i < count; i++) {
+            counts[((size_t)((long long)from[i] - base) >> digitShift) & (buckets - 1)]++;
+        }
+        size_t offset = 0;
+        for (size_t b = 0; b < buckets; b++) {
+            size_t bucketCount = counts[b];
+            counts[b] = offset;
+            offset += bucketCount;
+        }
+        for (size_t i = 0; i < count; i++) {
+            to[counts[((size_t)((long long)from[i] - base) >> digitShift) & (buckets - 1)]++] = from[i];
+        }
+    }
+}
+
+// Function to scan the runs of a sorted partition; lists up to maxModes values whose
+// run is best long when modes is not NULL
+static void scanSortedPartition(const ModeJob *job, size_t p, size_t *best, size_t *modeCount, int *modes, size_t maxModes) {
+    const int *values = job->partitioned + job->partitionStarts[p];
+    size_t count = job->partitionStarts[p + 1] - job->partitionStarts[p];
+    size_t start = 0;
+    for (size_t i = 1; i <= count; i++) {
+        if (i == count || values[i] != values[start]) {
+            size_t run = i - start;
+            if (modes == NULL && run > *best) {
+                *best = run;
+                *modeCount = 0;
+            }
+            if (run == *best) {
+                if (modes != NULL && *modeCount < maxModes) {
+                    modes[*modeCount] = values[start];
+                }
+                (*modeCount)++;
+            }
+            start = i;
+        }
+    }
+}
+
+static void partitionFrequencyChunk(void *context, int worker, size_t chunk, size_t begin, size_t end) {
+    ModeJob *job = (ModeJob *)context;
+    (void)chunk;
+    // Run with chunks of one partition each
+    for (size_t p = begin; p < end; p++) {
+        size_t size = job->partitionStarts[p + 1] - job->partitionStarts[p];
+        size_t best = 0;
+        size_t modeCount = 0;
+        if (size == 0) {
+            // Empty partition
+        } else if (job->scratch != NULL) {
+            unsigned int *counts = job->scratch + ((size_t)worker << job->shift);
+            countPartition(job, counts, p, &best, &modeCount);
+            clearPartition(job, counts, p);
+        } else if (size <= job->sortLimit) {
+            sortPartition(job, job->sortBuffers + (size_t)worker * job->sortLimit,
+                          job->radixCounts + ((size_t)worker << RADIX_DIGIT_BITS), p);
+            scanSortedPartition(job, p, &best, &modeCount, NULL, 0);
+        } else if (buildFrequencyTable(&job->tables[p], job->partitioned + job->partitionStarts[p], size) == 0) {
+            modeCount = findModes(&job->tables[p], NULL, 0, &best);
+        }
+        job->partitionBest[p] = best;
+        job->partitionModes[p] = modeCount;
+    }
+}
+
+size_t parallelModes(const int *arr, size_t n, int threads, int *modes, size_t maxModes, size_t *frequency) {
+    if (n == 0 || !arr || (!modes && maxModes > 0)) {
+        printf("Array is empty\n");
+        return 0;
+    }
+    threads = threadsFor(threads, n, PARALLEL_CHUNK);
+    getSimdLevel();
+
+    ModeJob job;
+    memset(&job, 0, sizeof(job));
+    job.arr = arr;
+    job.bounds = (int *)calloc(2 * (size_t)threads, sizeof(int));
+    job.found = (int *)calloc((size_t)threads, sizeof(int));
+    if (job.bounds == NULL || job.found == NULL) {
+        printf("Memory allocation failed\n");
+        free(job.bounds);
+        free(job.found);
+        return 0;
+    }
+    runParallel(threads, n, PARALLEL_CHUNK, modeBoundsChunk, &job);
+    int lo = 0, hi = 0, any = 0;
+    for (int t = 0; t < threads; t++) {
+        if (job.found[t]) {
+            lo = !any || job.bounds[2 * t] < lo ? job.bounds[2 * t] : lo;
+            hi = !any || job.bounds[2 * t + 1] > hi ? job.bounds[2 * t + 1] : hi;
+            any = 1;
+        }
+    }
+    free(job.bounds);
+    free(job.found);
+
+    size_t best = 0;
+    size_t modeCount = 0;
+    unsigned long long range = (unsigned long long)((long long)hi - (long long)lo) + 1;
+
+    if (range <= DIRECT_MODE_RANGE && range <= n) {
+        // Small range: per-worker counting arrays, summed in worker order
+        job.minValue = lo;
+        job.range = (size_t)range;
+        job.directCounts = (size_t *)calloc((size_t)threads * job.range, sizeof(size_t));
+        if (job.directCounts == NULL) {
+            printf("Memory allocation failed\n");
+            return 0;
+        }
+        runParallel(threads, n, PARALLEL_CHUNK, directCountChunk, &job);
+        for (size_t v = 0; v < job.range; v++) {
+            size_t count = 0;
+            for (int t = 0; t < threads; t++) {
+                count += job.directCounts[(size_t)t * job.range + v];
+            }
+            if (count > best) {
+                best = count;
+                modeCount = 0;
+            }
+            if (count == best) {
+                if (modeCount < maxModes) {
+                    modes[modeCount] = (int)((long long)lo + (long long)v);
+                }
+                modeCount++;
+            }
+        }
+        free(job.directCounts);
+    } else {
+        // Wide range: split the values into equal-width value ranges so each partition
+        // holds disjoint keys, then count partitions independently. Partitions are in
+        // ascending value order, so their modes concatenate sorted.
+        size_t chunks = (n + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+        job.minValue = lo;
+        job.shift = 0;
+        while ((range - 1) >> job.shift >= MODE_PARTITIONS) {
+            job.shift++;
+        }
+        job.chunkCounts = (size_t *)calloc(chunks * MODE_PARTITIONS, sizeof(size_t));
+        job.partitionStarts = (size_t *)malloc((MODE_PARTITIONS + 1) * sizeof(size_t));
+        job.partitionBest = (size_t *)calloc(MODE_PARTITIONS, sizeof(size_t));
+        job.partitionModes = (size_t *)calloc(MODE_PARTITIONS, sizeof(size_t));
+        job.partitioned = (int *)malloc(n * sizeof(int));
+        job.tables = (FrequencyTable *)calloc(MODE_PARTITIONS, sizeof(FrequencyTable));
+        int allocated = job.chunkCounts != NULL && job.partitionStarts != NULL && job.partitionBest != NULL
+                     && job.partitionModes != NULL && job.partitioned != NULL && job.tables != NULL;
+        if (allocated) {
+            runParallel(threads, n, PARALLEL_CHUNK, partitionCountChunk, &job);
+
+            // Exclusive prefix sums in (partition, chunk) order give every chunk its
+            // write positions, so the scatter is deterministic
+            size_t offset = 0;
+            size_t largest = 0;
+            for (size_t p = 0; p < MODE_PARTITIONS; p++) {
+                job.partitionStarts[p] = offset;
+                for (size_t c = 0; c < chunks; c++) {
+                    size_t count = job.chunkCounts[c * MODE_PARTITIONS + p];
+                    job.chunkCounts[c * MODE_PARTITIONS + p] = offset;
+                    offset += count;
+                }
+                largest = offset - job.partitionStarts[p] > largest ? offset - job.partitionStarts[p] : largest;
+            }
+            job.partitionStarts[MODE_PARTITIONS] = offset;
+
+            // Narrow partitions are counted in reusable per-worker arrays, wider ones
+            // radix sorted in per-worker buffers; only oversized partitions get a
+            // stats_mode table of their own
+            if (job.shift <= MODE_SCRATCH_BITS && n <= UINT_MAX) {
+                job.scratch = (unsigned int *)calloc((size_t)threads << job.shift, sizeof(unsigned int));
+                allocated = job.scratch != NULL;
+            } else {
+                job.sortLimit = largest < MODE_SORT_LIMIT ? largest : MODE_SORT_LIMIT;
+                job.sortBuffers = (int *)malloc((size_t)threads * job.sortLimit * sizeof(int));
+                job.radixCounts = (size_t *)malloc(((size_t)threads << RADIX_DIGIT_BITS) * sizeof(size_t));
+                allocated = job.sortBuffers != NULL && job.radixCounts != NULL;
+            }
+        }
+        if (!allocated) {
+            printf("Memory allocation failed\n");
+            free(job.chunkCounts);
+            free(job.partitionStarts);
+            free(job.partitionBest);
+            free(job.partitionModes);
+            free(job.partitioned);
+            free(job.tables);
+            free(job.scratch);
+            free(job.sortBuffers);
+            free(job.radixCounts);
+            return 0;
+        }
+        runParallel(threads, n, PARALLEL_CHUNK, partitionScatterChunk, &job);
+        runParallel(threads, MODE_PARTITIONS, 1, partitionFrequencyChunk, &job);
+
+        for (size_t p = 0; p < MODE_PARTITIONS; p++) {
+            best = job.partitionBest[p] > best ? job.partitionBest[p] : best;
+        }
+
+        // Partitions reaching the top frequency contribute modes, in ascending value
+        // order; they are only listed again while there is room for more
+        for (size_t p = 0; p < MODE_PARTITIONS; p++) {
+            size_t size = job.partitionStarts[p + 1] - job.partitionStarts[p];
+            if (job.partitionBest[p] == best && modeCount < maxModes) {
+                if (job.scratch != NULL) {
+                    long long base = (long long)job.minValue + ((long long)p << job.shift);
+                    size_t span = (size_t)1 << job.shift;
+                    size_t partitionBest, partitionModes;
+                    size_t listed = modeCount;
+                    countPartition(&job, job.scratch, p, &partitionBest, &partitionModes);
+                    for (size_t v = 0; v < span && listed < maxModes; v++) {
+                        if (job.scratch[v] == best) {
+                            modes[listed++] = (int)(base + (long long)v);
+                        }
+                    }
+                    clearPartition(&job, job.scratch, p);
+                } else if (size <= job.sortLimit) {
+                    size_t listed = modeCount;
+                    scanSortedPartition(&job, p, &best, &listed, modes, maxModes);
+                } else {
+                    size_t partitionFrequency = 0;
+                    findModes(&job.tables[p], modes + modeCount, maxModes - modeCount, &partitionFrequency);
+                }
+            }
+            if (job.partitionBest[p] == best) {
+                modeCount += job.partitionModes[p];
+            }
+            freeFrequencyTable(&job.tables[p]);
+        }
+        free(job.chunkCounts);
+        free(job.partitionStarts);
+        free(job.partitionBest);
+        free(job.partitionModes);
+        free(job.partitioned);
+        free(job.tables);
+        free(job.scratch);
+        free(job.sortBuffers);
+        free(job.radixCounts);
+    }
+
+    if (frequency) {
+        *frequency = best;
+    }
+    return modeCount;
+}
@@ -0,0 +1,38 @@
+#ifndef STATS_PARALLEL_H
+#define STATS_PARALLEL_H
+
+#include <stddef.h>
+
+// Multi-threaded statistics over large int arrays. The array is cut into
+// cache-sized chunks (PARALLEL_CHUNK elements) that worker threads claim from a
+// shared counter, so faster cores simply take more chunks. The worker threads are
+// started on first use and kept for later calls. Every partial result is
+// an exact integer (64/128-bit sums, counts), so merging is deterministic: results
+// are identical for any thread count and any scheduling.
+//
+// threads <= 0 uses one thread per CPU. The input array is never modified.
+
+#define PARALLEL_CHUNK ((size_t)1 << 16)
+
+// Function to return the number of online CPUs
+int cpuCount(void);
+
+double parallelMean(const int *arr, size_t n, int threads);
+double parallelVariance(const int *arr, size_t n, int threads); // Sample variance
+
+// Function to count values into bins (see histogramInts); counts is added to
+void parallelHistogram(const int *arr, size_t n, int threads, int low, int binWidth, size_t bins, size_t *counts);
+
+// Function to find the k-th smallest element (0-based) by parallel radix selection:
+// each pass histograms the remaining value range into 2^16 buckets and keeps the
+// bucket holding rank k, so at most three passes are needed
+int parallelSelect(const int *arr, size_t n, int threads, size_t k);
+
+// Function to calculate the median (mean of the two middle values for even n)
+double parallelMedian(const int *arr, size_t n, int threads);
+
+// Function to list the modes in ascending order (see findModes): writes up to
+// maxModes of them, stores their frequency and returns how many there are
+size_t parallelModes(const int *arr, size_t n, int threads, int *modes, size_t maxModes, size_t *frequency);
+
+#endif // STATS_PARALLEL_H
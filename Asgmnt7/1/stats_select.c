@@ -0,0 +1,259 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stats_select.h"
+
+#define SMALL_RANGE 16  // Ranges up to this size are finished with insertion sort
+
+// Function to sort a small range in place
+static void insertionSort(int *arr, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        int value = arr[i];
+        size_t j = i;
+        while (j > 0 && arr[j - 1] > value) {
+            arr[j] = arr[j - 1];
+            j--;
+        }
+        arr[j] = value;
+    }
+}
+
+// Function to partition arr[lo, hi) into [< pivot][== pivot][> pivot].
+// Sets *lt and *gt to the bounds of the == block. Grouping equal keys keeps
+// heavily duplicated data linear.
+static void partition3(int *arr, size_t lo, size_t hi, int pivot, size_t *lt, size_t *gt) {
+    size_t less = lo;
+    size_t i = lo;
+    size_t greater = hi;
+
+    while (i < greater) {
+        int value = arr[i];
+        if (value < pivot) {
+            arr[i++] = arr[less];
+            arr[less++] = value;
+        } else if (value > pivot) {
+            arr[i] = arr[--greater];
+            arr[greater] = value;
+        } else {
+            i++;
+        }
+    }
+    *lt = less;
+    *gt = greater;
+}
+
+// Function to return the median of three values
+static int medianOf3(int a, int b, int c) {
+    if (a < b) {
+        return b < c ? b : (a < c ? c : a);
+    }
+    return a < c ? a : (b < c ? c : b);
+}
+
+// Function to pick a cheap pivot: median of three, or Tukey's ninther on large ranges
+static int samplePivot(const int *arr, size_t lo, size_t hi) {
+    size_t n = hi - lo;
+    size_t mid = lo + n / 2;
+    if (n < 512) {
+        return medianOf3(arr[lo], arr[mid], arr[hi - 1]);
+    }
+    size_t step = n / 8;
+    return medianOf3(medianOf3(arr[lo], arr[lo + step], arr[lo + 2 * step]),
+                     medianOf3(arr[mid - step], arr[mid], arr[mid + step]),
+                     medianOf3(arr[hi - 1 - 2 * step], arr[hi - 1 - step], arr[hi - 1]));
+}
+
+static void selectRange(int *arr, size_t lo, size_t hi, size_t k, int budget);
+
+// Function to pick a pivot with a guaranteed 30/70 split: the median of the
+// medians of groups of five. Group medians are gathered at the front of the range.
+static int medianOfMedians(int *arr, size_t lo, size_t hi) {
+    size_t groups = 0;
+    for (size_t start = lo; start < hi; start += 5) {
+        size_t size = hi - start < 5 ? hi - start : 5;
+        insertionSort(arr + start, size);
+        int median = arr[start + size / 2];
+        arr[start + size / 2] = arr[lo + groups];
+        arr[lo + groups] = median;
+        groups++;
+    }
+    size_t k = lo + groups / 2;
+    selectRange(arr, lo, lo + groups, k, 0);
+    return arr[k];
+}
+
+// Function to place the k-th smallest of arr[lo, hi) at index k. Each partition that
+// fails to discard a quarter of the range spends budget; at zero, pivots switch to
+// median-of-medians so adversarial inputs stay linear.
+static void selectRange(int *arr, size_t lo, size_t hi, size_t k, int budget) {
+    while (hi - lo > SMALL_RANGE) {
+        size_t n = hi - lo;
+        int pivot = budget > 0 ? samplePivot(arr, lo, hi) : medianOfMedians(arr, lo, hi);
+        size_t lt, gt;
+        partition3(arr, lo, hi, pivot, &lt, &gt);
+
+        if (k < lt) {
+            hi = lt;
+        } else if (k >= gt) {
+            lo = gt;
+        } else {
+            return; // arr[k] == pivot
+        }
+        if (budget > 0 && hi - lo > n - n / 4) {
+            budget--;
+        }
+    }
+    insertionSort(arr + lo, hi - lo);
+}
+
+// Function to place every rank of ranks[0, count) (sorted, within [lo, hi)) at its
+// index. One partition serves all ranks, which are then split between both sides.
+static void multiSelect(int *arr, size_t lo, size_t hi, const size_t *ranks, size_t count, int budget) {
+    while (count > 1 && hi - lo > SMALL_RANGE) {
+        size_t n = hi - lo;
+        int pivot = budget > 0 ? samplePivot(arr, lo, hi) : medianOfMedians(arr, lo, hi);
+        size_t lt, gt;
+        partition3(arr, lo, hi, pivot, &lt, &gt);
+        if (budget > 0 && (lt - lo > n - n / 4 || hi - gt > n - n / 4)) {
+            budget--;
+        }
+
+        size_t left = 0;
+        while (left < count && ranks[left] < lt) {
+            left++;
+        }
+        size_t right = left;
+        while (right < count && ranks[right] < gt) {
+            right++; // Ranks inside the == block are already in place
+        }
+
+        // Recurse on the side with fewer ranks, loop on the other
+        if (left < count - right) {
+            multiSelect(arr, lo, lt, ranks, left, budget);
+            lo = gt;
+            ranks += right;
+            count -= right;
+        } else {
+            multiSelect(arr, gt, hi, ranks + right, count - right, budget);
+            hi = lt;
+            count = left;
+        }
+    }
+
+    if (count == 1) {
+        selectRange(arr, lo, hi, ranks[0], budget);
+    } else if (count > 1) {
+        insertionSort(arr + lo, hi - lo);
+    }
+}
+
+// Function to give the depth budget for n elements: about 2 * log2(n)
+static int selectBudget(size_t n) {
+    int budget = 0;
+    while (n > 1) {
+        n >>= 1;
+        budget += 2;
+    }
+    return budget;
+}
+
+int selectKth(int *arr, size_t n, size_t k) {
+    if (!arr || k >= n) {
+        printf("Invalid arguments\n");
+        return 0;
+    }
+    selectRange(arr, 0, n, k, selectBudget(n));
+    return arr[k];
+}
+
+double calculateQuantile(int *arr, size_t n, double q) {
+    double result = 0.0;
+    calculateQuantiles(arr, n, &q, &result, 1);
+    return result;
+}
+
+// Function to sort ranks ascending and drop duplicates; returns the new count
+static size_t uniqueRanks(size_t *ranks, size_t count) {
+    for (size_t i = 1; i < count; i++) {
+        size_t value = ranks[i];
+        size_t j = i;
+        while (j > 0 && ranks[j - 1] > value) {
+            ranks[j] = ranks[j - 1];
+            j--;
+        }
+        ranks[j] = value;
+    }
+    size_t unique = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (unique == 0 || ranks[unique - 1] != ranks[i]) {
+            ranks[unique++] = ranks[i];
+        }
+    }
+    return unique;
+}
+
+int calculateQuantiles(int *arr, size_t n, const double *qs, double *out, size_t count) {
+    if (n == 0 || !arr) {
+        printf("Array is empty\n");
+        return -1;
+    }
+    if (!qs || !out) {
+        printf("Invalid arguments\n");
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!(qs[i] >= 0.0 && qs[i] <= 1.0)) {
+            printf("Quantile must be between 0 and 1\n");
+            return -1;
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    // Each quantile needs the two ranks around its position q * (n - 1)
+    size_t localRanks[32];
+    size_t *ranks = count <= 16 ? localRanks : (size_t *)malloc(2 * count * sizeof(size_t));
+    if (ranks == NULL) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t below = (size_t)(qs[i] * (double)(n - 1));
+        ranks[2 * i] = below;
+        ranks[2 * i + 1] = below + 1 < n ? below + 1 : below;
+    }
+    size_t unique = uniqueRanks(ranks, 2 * count);
+    multiSelect(arr, 0, n, ranks, unique, selectBudget(n));
+
+    for (size_t i = 0; i < count; i++) {
+        double position = qs[i] * (double)(n - 1);
+        size_t below = (size_t)position;
+        size_t above = below + 1 < n ? below + 1 : below;
+        double fraction = position - (double)below;
+        out[i] = (double)arr[below] + fraction * ((double)arr[above] - (double)arr[below]);
+    }
+
+    if (ranks != localRanks) {
+        free(ranks);
+    }
+    return 0;
+}
+
+int calculateQuantilesCopy(const int *arr, size_t n, const double *qs, double *out, size_t count, int *scratch) {
+    if (n == 0 || !arr) {
+        printf("Array is empty\n");
+        return -1;
+    }
+    int *work = scratch ? scratch : (int *)malloc(n * sizeof(int));
+    if (work == NULL) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+    memcpy(work, arr, n * sizeof(int));
+    int status = calculateQuantiles(work, n, qs, out, count);
+    if (work != scratch) {
+        free(work);
+    }
+    return status;
+}
@@ -0,0 +1,27 @@
+#ifndef STATS_SELECT_H
+#define STATS_SELECT_H
+
+#include <stddef.h>
+
+// Selection-based order statistics (introselect). Each query runs in O(n) expected
+// time and O(n) worst case: quickselect with three-way partitioning falls back to
+// median-of-medians pivots when partitions keep coming out unbalanced.
+// Quantiles use linear interpolation between the closest ranks, so q = 0.5 gives the
+// usual median (mean of the two middle values for even n).
+
+// Function to find the k-th smallest element (0-based). Reorders arr so that
+// arr[k] holds it, with smaller-or-equal elements before and greater-or-equal after.
+int selectKth(int *arr, size_t n, size_t k);
+
+// Function to calculate one quantile, 0 <= q <= 1 (reorders arr)
+double calculateQuantile(int *arr, size_t n, double q);
+
+// Function to calculate several quantiles (e.g. p50/p90/p99) with one shared
+// partitioning pass; qs may be in any order. Reorders arr. Returns 0, or -1 on error.
+int calculateQuantiles(int *arr, size_t n, const double *qs, double *out, size_t count);
+
+// Non-mutating variant: works on a copy in scratch (n ints), or on an internal
+// buffer if scratch is NULL. Returns 0, or -1 on error.
+int calculateQuantilesCopy(const int *arr, size_t n, const double *qs, double *out, size_t count, int *scratch);
+
+#endif // STATS_SELECT_H
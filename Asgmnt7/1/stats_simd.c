@@ -0,0 +1,584 @@
+#include <stdio.h>
+#include "stats_simd.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define STATS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+#define LOW32 0xFFFFFFFFULL
+#define BIN_BLOCK 1024  // Bin indices computed per vector pass
+
+// Sums of squares are accumulated as two 64-bit parts, the high and low 32 bits of
+// each square, which cannot overflow for n < 2^32; they are combined at the end.
+typedef struct {
+    unsigned long long high;
+    unsigned long long low;
+} SquareParts;
+
+// Bin mapping shared by every level: index = trunc(min(max(x - low, 0) * inverse, last)).
+// The reciprocal is rounded up by a few ulps so the product never falls below the
+// true quotient, which keeps truncation exact for every int input.
+typedef struct {
+    double low;
+    double inverse;
+    double last;
+} BinParams;
+
+typedef struct {
+    long long (*sum)(const int *arr, size_t n);
+    SquareParts (*sumSquares)(const int *arr, size_t n);
+    void (*minMax)(const int *arr, size_t n, int *minValue, int *maxValue);
+    void (*binIndices)(const int *arr, size_t n, const BinParams *params, int *indices);
+} KernelTable;
+
+// ---------------------------------------------------------------------------
+// Scalar kernels
+// ---------------------------------------------------------------------------
+
+static long long sumScalar(const int *arr, size_t n) {
+    long long s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += arr[i];
+        s1 += arr[i + 1];
+        s2 += arr[i + 2];
+        s3 += arr[i + 3];
+    }
+    for (; i < n; i++) {
+        s0 += arr[i];
+    }
+    return s0 + s1 + s2 + s3;
+}
+
+static SquareParts sumSquaresScalar(const int *arr, size_t n) {
+    SquareParts parts = {0, 0};
+    for (size_t i = 0; i < n; i++) {
+        unsigned long long square = (unsigned long long)((long long)arr[i] * arr[i]);
+        parts.high += square >> 32;
+        parts.low += square & LOW32;
+    }
+    return parts;
+}
+
+static void minMaxScalar(const int *arr, size_t n, int *minValue, int *maxValue) {
+    int lo = arr[0];
+    int hi = arr[0];
+    for (size_t i = 1; i < n; i++) {
+        lo = arr[i] < lo ? arr[i] : lo;
+        hi = arr[i] > hi ? arr[i] : hi;
+    }
+    *minValue = lo;
+    *maxValue = hi;
+}
+
+static int binIndexScalar(int value, const BinParams *params) {
+    double offset = (double)value - params->low;
+    double bin = (offset > 0.0 ? offset : 0.0) * params->inverse;
+    return (int)(bin < params->last ? bin : params->last);
+}
+
+static void binIndicesScalar(const int *arr, size_t n, const BinParams *params, int *indices) {
+    for (size_t i = 0; i < n; i++) {
+        indices[i] = binIndexScalar(arr[i], params);
+    }
+}
+
+static const KernelTable SCALAR_KERNELS = {
+    sumScalar, sumSquaresScalar, minMaxScalar, binIndicesScalar
+};
+
+#ifdef STATS_X86
+
+// ---------------------------------------------------------------------------
+// SSE2 kernels (baseline on x86-64)
+// ---------------------------------------------------------------------------
+
+static long long sumSse2(const int *arr, size_t n) {
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(arr + i));
+        __m128i sign = _mm_srai_epi32(x, 31);
+        acc0 = _mm_add_epi64(acc0, _mm_unpacklo_epi32(x, sign)); // Sign-extend to 64 bits
+        acc1 = _mm_add_epi64(acc1, _mm_unpackhi_epi32(x, sign));
+    }
+    long long lanes[2];
+    _mm_storeu_si128((__m128i *)lanes, _mm_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + sumScalar(arr + i, n - i);
+}
+
+static SquareParts sumSquaresSse2(const int *arr, size_t n) {
+    const __m128i low32 = _mm_set1_epi64x((long long)LOW32);
+    __m128i high = _mm_setzero_si128();
+    __m128i low = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(arr + i));
+        __m128i sign = _mm_srai_epi32(x, 31);
+        __m128i magnitude = _mm_sub_epi32(_mm_xor_si128(x, sign), sign); // |x| as unsigned
+        __m128i oddLanes = _mm_srli_epi64(magnitude, 32);
+        __m128i even = _mm_mul_epu32(magnitude, magnitude);
+        __m128i odd = _mm_mul_epu32(oddLanes, oddLanes);
+        high = _mm_add_epi64(high, _mm_add_epi64(_mm_srli_epi64(even, 32), _mm_srli_epi64(odd, 32)));
+        low = _mm_add_epi64(low, _mm_add_epi64(_mm_and_si128(even, low32), _mm_and_si128(odd, low32)));
+    }
+    unsigned long long highLanes[2];
+    unsigned long long lowLanes[2];
+    _mm_storeu_si128((__m128i *)highLanes, high);
+    _mm_storeu_si128((__m128i *)lowLanes, low);
+    SquareParts parts = sumSquaresScalar(arr + i, n - i);
+    parts.high += highLanes[0] + highLanes[1];
+    parts.low += lowLanes[0] + lowLanes[1];
+    return parts;
+}
+
+static void minMaxSse2(const int *arr, size_t n, int *minValue, int *maxValue) {
+    if (n < 4) {
+        minMaxScalar(arr, n, minValue, maxValue);
+        return;
+    }
+    __m128i lo = _mm_loadu_si128((const __m128i *)arr);
+    __m128i hi = lo;
+    size_t i = 4;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(arr + i));
+        __m128i less = _mm_cmplt_epi32(x, lo);      // SSE2 has no pminsd/pmaxsd
+        __m128i greater = _mm_cmpgt_epi32(x, hi);
+        lo = _mm_or_si128(_mm_and_si128(less, x), _mm_andnot_si128(less, lo));
+        hi = _mm_or_si128(_mm_and_si128(greater, x), _mm_andnot_si128(greater, hi));
+    }
+    int loLanes[4];
+    int hiLanes[4];
+    _mm_storeu_si128((__m128i *)loLanes, lo);
+    _mm_storeu_si128((__m128i *)hiLanes, hi);
+    int resultLo = loLanes[0];
+    int resultHi = hiLanes[0];
+    for (int lane = 1; lane < 4; lane++) {
+        resultLo = loLanes[lane] < resultLo ? loLanes[lane] : resultLo;
+        resultHi = hiLanes[lane] > resultHi ? hiLanes[lane] : resultHi;
+    }
+    for (; i < n; i++) {
+        resultLo = arr[i] < resultLo ? arr[i] : resultLo;
+        resultHi = arr[i] > resultHi ? arr[i] : resultHi;
+    }
+    *minValue = resultLo;
+    *maxValue = resultHi;
+}
+
+static void binIndicesSse2(const int *arr, size_t n, const BinParams *params, int *indices) {
+    const __m128d low = _mm_set1_pd(params->low);
+    const __m128d inverse = _mm_set1_pd(params->inverse);
+    const __m128d last = _mm_set1_pd(params->last);
+    const __m128d zero = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d x = _mm_cvtepi32_pd(_mm_loadl_epi64((const __m128i *)(arr + i)));
+        __m128d bin = _mm_min_pd(_mm_mul_pd(_mm_max_pd(_mm_sub_pd(x, low), zero), inverse), last);
+        _mm_storel_epi64((__m128i *)(indices + i), _mm_cvttpd_epi32(bin));
+    }
+    binIndicesScalar(arr + i, n - i, params, indices + i);
+}
+
+static const KernelTable SSE2_KERNELS = {
+    sumSse2, sumSquaresSse2, minMaxSse2, binIndicesSse2
+};
+
+// ---------------------------------------------------------------------------
+// AVX2 kernels
+// ---------------------------------------------------------------------------
+
+TARGET_AVX2 static long long sumAvx2(const int *arr, size_t n) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(arr + i));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+    }
+    long long lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, _mm256_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalar(arr + i, n - i);
+}
+
+TARGET_AVX2 static SquareParts sumSquaresAvx2(const int *arr, size_t n) {
+    const __m256i low32 = _mm256_set1_epi64x((long long)LOW32);
+    __m256i high = _mm256_setzero_si256();
+    __m256i low = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i magnitude = _mm256_abs_epi32(_mm256_loadu_si256((const __m256i *)(arr + i)));
+        __m256i oddLanes = _mm256_srli_epi64(magnitude, 32);
+        __m256i even = _mm256_mul_epu32(magnitude, magnitude);
+        __m256i odd = _mm256_mul_epu32(oddLanes, oddLanes);
+        high = _mm256_add_epi64(high, _mm256_add_epi64(_mm256_srli_epi64(even, 32), _mm256_srli_epi64(odd, 32)));
+        low = _mm256_add_epi64(low, _mm256_add_epi64(_mm256_and_si256(even, low32), _mm256_and_si256(odd, low32)));
+    }
+    unsigned long long highLanes[4];
+    unsigned long long lowLanes[4];
+    _mm256_storeu_si256((__m256i *)highLanes, high);
+    _mm256_storeu_si256((__m256i *)lowLanes, low);
+    SquareParts parts = sumSquaresScalar(arr + i, n - i);
+    for (int lane = 0; lane < 4; lane++) {
+        parts.high += highLanes[lane];
+        parts.low += lowLanes[lane];
+    }
+    return parts;
+}
+
+TARGET_AVX2 static void minMaxAvx2(const int *arr, size_t n, int *minValue, int *maxValue) {
+    if (n < 8) {
+        minMaxScalar(arr, n, minValue, maxValue);
+        return;
+    }
+    __m256i lo = _mm256_loadu_si256((const __m256i *)arr);
+    __m256i hi = lo;
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(arr + i));
+        lo = _mm256_min_epi32(lo, x);
+        hi = _mm256_max_epi32(hi, x);
+    }
+    int loLanes[8];
+    int hiLanes[8];
+    _mm256_storeu_si256((__m256i *)loLanes, lo);
+    _mm256_storeu_si256((__m256i *)hiLanes, hi);
+    int resultLo = loLanes[0];
+    int resultHi = hiLanes[0];
+    for (int lane = 1; lane < 8; lane++) {
+        resultLo = loLanes[lane] < resultLo ? loLanes[lane] : resultLo;
+        resultHi = hiLanes[lane] > resultHi ? hiLanes[lane] : resultHi;
+    }
+    for (; i < n; i++) {
+        resultLo = arr[i] < resultLo ? arr[i] : resultLo;
+        resultHi = arr[i] > resultHi ? arr[i] : resultHi;
+    }
+    *minValue = resultLo;
+    *maxValue = resultHi;
+}
+
+TARGET_AVX2 static void binIndicesAvx2(const int *arr, size_t n, const BinParams *params, int *indices) {
+    const __m256d low = _mm256_set1_pd(params->low);
+    const __m256d inverse = _mm256_set1_pd(params->inverse);
+    const __m256d last = _mm256_set1_pd(params->last);
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d x = _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i *)(arr + i)));
+        __m256d bin = _mm256_min_pd(_mm256_mul_pd(_mm256_max_pd(_mm256_sub_pd(x, low), zero), inverse), last);
+        _mm_storeu_si128((__m128i *)(indices + i), _mm256_cvttpd_epi32(bin));
+    }
+    binIndicesScalar(arr + i, n - i, params, indices + i);
+}
+
+static const KernelTable AVX2_KERNELS = {
+    sumAvx2, sumSquaresAvx2, minMaxAvx2, binIndicesAvx2
+};
+
+// ---------------------------------------------------------------------------
+// AVX-512 kernels
+// ---------------------------------------------------------------------------
+
+TARGET_AVX512 static long long sumAvx512(const int *arr, size_t n) {
+    __m512i acc0 = _mm512_setzero_si512();
+    __m512i acc1 = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i x = _mm512_loadu_si512((const void *)(arr + i));
+        acc0 = _mm512_add_epi64(acc0, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(x)));
+        acc1 = _mm512_add_epi64(acc1, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1)));
+    }
+    return _mm512_reduce_add_epi64(_mm512_add_epi64(acc0, acc1)) + sumScalar(arr + i, n - i);
+}
+
+TARGET_AVX512 static SquareParts sumSquaresAvx512(const int *arr, size_t n) {
+    const __m512i low32 = _mm512_set1_epi64((long long)LOW32);
+    __m512i high = _mm512_setzero_si512();
+    __m512i low = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m512i magnitude = _mm512_abs_epi32(_mm512_loadu_si512((const void *)(arr + i)));
+        __m512i oddLanes = _mm512_srli_epi64(magnitude, 32);
+        __m512i even = _mm512_mul_epu32(magnitude, magnitude);
+        __m512i odd = _mm512_mul_epu32(oddLanes, oddLanes);
+        high = _mm512_add_epi64(high, _mm512_add_epi64(_mm512_srli_epi64(even, 32), _mm512_srli_epi64(odd, 32)));
+        low = _mm512_add_epi64(low, _mm512_add_epi64(_mm512_and_si512(even, low32), _mm512_and_si512(odd, low32)));
+    }
+    SquareParts parts = sumSquaresScalar(arr + i, n - i);
+    parts.high += (unsigned long long)_mm512_reduce_add_epi64(high);
+    parts.low += (unsigned long long)_mm512_reduce_add_epi64(low);
+    return parts;
+}
+
+TARGET_AVX512 static void minMaxAvx512(const int *arr, size_t n, int *minValue, int *maxValue) {
+    if (n < 16) {
+        minMaxScalar(arr, n, minValue, maxValue);
+        return;
+    }
+    __m512i lo = _mm512_loadu_si512((const void *)arr);
+    __m512i hi = lo;
+    size_t i = 16;
+    for (; i + 16 <= n; i += 16) {
+        __m512i x = _mm512_loadu_si512((const void *)(arr + i));
+        lo = _mm512_min_epi32(lo, x);
+        hi = _mm512_max_epi32(hi, x);
+    }
+    int resultLo = _mm512_reduce_min_epi32(lo);
+    int resultHi = _mm512_reduce_max_epi32(hi);
+    for (; i < n; i++) {
+        resultLo = arr[i] < resultLo ? arr[i] : resultLo;
+        resultHi = arr[i] > resultHi ? arr[i] : resultHi;
+    }
+    *minValue = resultLo;
+    *maxValue = resultHi;
+}
+
+TARGET_AVX512 static void binIndicesAvx512(const int *arr, size_t n, const BinParams *params, int *indices) {
+    const __m512d low = _mm512_set1_pd(params->low);
+    const __m512d inverse = _mm512_set1_pd(params->inverse);
+    const __m512d last = _mm512_set1_pd(params->last);
+    const __m512d zero = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d x = _mm512_cvtepi32_pd(_mm256_loadu_si256((const __m256i *)(arr + i)));
+        __m512d bin = _mm512_min_pd(_mm512_mul_pd(_mm512_max_pd(_mm512_sub_pd(x, low), zero), inverse), last);
+        _mm256_storeu_si256((__m256i *)(indices + i), _mm512_cvttpd_epi32(bin));
+    }
+    binIndicesScalar(arr + i, n - i, params, indices + i);
+}
+
+static const KernelTable AVX512_KERNELS = {
+    sumAvx512, sumSquaresAvx512, minMaxAvx512, binIndicesAvx512
+};
+
+#endif // STATS_X86
+
+// ---------------------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------------------
+
+static int levelChosen = 0;
+static SimdLevel activeLevel = SIMD_SCALAR;
+static const KernelTable *activeKernels = &SCALAR_KERNELS;
+
+SimdLevel detectSimdLevel(void) {
+#if defined(STATS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    int sse2 = (info[3] >> 26) & 1;
+    int osxsave = (info[2] >> 27) & 1;
+    int avx = (info[2] >> 28) & 1;
+    unsigned long long xcr0 = osxsave ? _xgetbv(0) : 0;
+    int avx2 = 0;
+    int avx512 = 0;
+    if (maxLeaf >= 7) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] >> 5) & 1;
+        avx512 = (info[1] >> 16) & 1;
+    }
+    // The OS must save the vector registers too: YMM state for AVX2, ZMM for AVX-512
+    int ymmEnabled = (xcr0 & 0x6) == 0x6;
+    int zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+    if (avx && avx512 && zmmEnabled) {
+        return SIMD_AVX512;
+    }
+    if (avx && avx2 && ymmEnabled) {
+        return SIMD_AVX2;
+    }
+    return sse2 ? SIMD_SSE2 : SIMD_SCALAR;
+#elif defined(STATS_X86)
+    // GCC and Clang check OS support for the wider registers as well
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SIMD_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SIMD_AVX2;
+    }
+    return __builtin_cpu_supports("sse2") ? SIMD_SSE2 : SIMD_SCALAR;
+#else
+    return SIMD_SCALAR;
+#endif
+}
+
+void setSimdLevel(SimdLevel level) {
+    SimdLevel supported = detectSimdLevel();
+    activeLevel = level < supported ? level : supported;
+#ifdef STATS_X86
+    switch (activeLevel) {
+    case SIMD_AVX512:
+        activeKernels = &AVX512_KERNELS;
+        break;
+    case SIMD_AVX2:
+        activeKernels = &AVX2_KERNELS;
+        break;
+    case SIMD_SSE2:
+        activeKernels = &SSE2_KERNELS;
+        break;
+    default:
+        activeKernels = &SCALAR_KERNELS;
+        break;
+    }
+#else
+    activeKernels = &SCALAR_KERNELS;
+#endif
+    levelChosen = 1;
+}
+
+// Function to return the kernels, choosing them on first use. Call getSimdLevel()
+// once before starting threads that use the kernels.
+static const KernelTable *kernels(void) {
+    if (!levelChosen) {
+        setSimdLevel(SIMD_AVX512);
+    }
+    return activeKernels;
+}
+
+SimdLevel getSimdLevel(void) {
+    kernels();
+    return activeLevel;
+}
+
+const char *simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SIMD_AVX512:
+        return "AVX-512";
+    case SIMD_AVX2:
+        return "AVX2";
+    case SIMD_SSE2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Public kernels
+// ---------------------------------------------------------------------------
+
+long long sumInts(const int *arr, size_t n) {
+    if (!arr && n > 0) {
+        printf("Array is invalid\n");
+        return 0;
+    }
+    return n == 0 ? 0 : kernels()->sum(arr, n);
+}
+
+Wide128 sumSquaresInts(const int *arr, size_t n) {
+    Wide128 result = {0, 0};
+    if (!arr && n > 0) {
+        printf("Array is invalid\n");
+        return result;
+    }
+    if (n == 0) {
+        return result;
+    }
+    SquareParts parts = kernels()->sumSquares(arr, n);
+    // result = high * 2^32 + low
+    result.hi = parts.high >> 32;
+    result.lo = parts.high << 32;
+    result.lo += parts.low;
+    result.hi += result.lo < parts.low; // Carry
+    return result;
+}
+
+void minMaxInts(const int *arr, size_t n, int *minValue, int *maxValue) {
+    if (n == 0 || !arr || !minValue || !maxValue) {
+        printf("Array is empty\n");
+        return;
+    }
+    kernels()->minMax(arr, n, minValue, maxValue);
+}
+
+void histogramInts(const int *arr, size_t n, int low, int binWidth, size_t bins, size_t *counts) {
+    if ((!arr && n > 0) || !counts || bins == 0 || binWidth <= 0) {
+        printf("Invalid arguments\n");
+        return;
+    }
+    if (bins > 0x7FFFFFFF) {
+        bins = 0x7FFFFFFF; // Bin indices are computed as int
+    }
+
+    BinParams params;
+    params.low = (double)low;
+    params.inverse = (1.0 / binWidth) * (1.0 + 4.0 / 9007199254740992.0); // Up by 4 ulps
+    params.last = (double)(bins - 1);
+
+    int indices[BIN_BLOCK];
+    const KernelTable *table = kernels();
+    for (size_t start = 0; start < n; start += BIN_BLOCK) {
+        size_t block = n - start < BIN_BLOCK ? n - start : BIN_BLOCK;
+        table->binIndices(arr + start, block, &params, indices);
+        for (size_t i = 0; i < block; i++) {
+            counts[indices[i]]++;
+        }
+    }
+}
+
+// Function to multiply two 64-bit values into a 128-bit product
+static Wide128 multiply64(unsigned long long a, unsigned long long b) {
+    unsigned long long aLo = a & LOW32, aHi = a >> 32;
+    unsigned long long bLo = b & LOW32, bHi = b >> 32;
+    unsigned long long lolo = aLo * bLo;
+    unsigned long long hilo = aHi * bLo;
+    unsigned long long lohi = aLo * bHi;
+    unsigned long long cross = (lolo >> 32) + (hilo & LOW32) + (lohi & LOW32);
+    Wide128 product;
+    product.lo = (cross << 32) | (lolo & LOW32);
+    product.hi = aHi * bHi + (hilo >> 32) + (lohi >> 32) + (cross >> 32);
+    return product;
+}
+
+double meanInts(const int *arr, size_t n) {
+    if (n == 0 || !arr) {
+        printf("Num of elements is 0\n");
+        return 0.0;
+    }
+    return (double)sumInts(arr, n) / (double)n;
+}
+
+Wide128 addWide128(Wide128 a, Wide128 b) {
+    Wide128 result;
+    result.lo = a.lo + b.lo;
+    result.hi = a.hi + b.hi + (result.lo < a.lo);
+    return result;
+}
+
+double varianceFromSums(size_t n, long long sum, Wide128 squares) {
+    if (n < 2) {
+        return 0.0;
+    }
+
+    // n * sum(x^2) - sum(x)^2, exactly in 128 bits (both terms stay below 2^126),
+    // so there is no cancellation however large the mean is
+    Wide128 scaled = multiply64(squares.lo, n);
+    scaled.hi += squares.hi * n;
+    unsigned long long magnitude = sum < 0 ? 0ULL - (unsigned long long)sum : (unsigned long long)sum;
+    Wide128 sumSquared = multiply64(magnitude, magnitude);
+
+    Wide128 numerator;
+    numerator.lo = scaled.lo - sumSquared.lo;
+    numerator.hi = scaled.hi - sumSquared.hi - (scaled.lo < sumSquared.lo);
+
+    double value = (double)numerator.hi * 18446744073709551616.0 + (double)numerator.lo;
+    return value / ((double)n * (double)(n - 1));
+}
+
+double varianceInts(const int *arr, size_t n) {
+    if (n < 2 || !arr) {
+        return 0.0;
+    }
+    return varianceFromSums(n, sumInts(arr, n), sumSquaresInts(arr, n));
+}
@@ -0,0 +1,56 @@
+#ifndef STATS_SIMD_H
+#define STATS_SIMD_H
+
+#include <stddef.h>
+
+// Vectorized reduction kernels over int arrays. The widest instruction set the CPU
+// (and OS) supports is picked at run time through cpuid; every kernel also has a
+// portable scalar version, used on non-x86 builds.
+//
+// Accumulators are wide enough to be exact: sums use 64-bit lanes and sums of
+// squares are kept as 128-bit values, for any n below 2^32.
+
+typedef enum {
+    SIMD_SCALAR,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512
+} SimdLevel;
+
+// Unsigned 128-bit value (portable: MSVC has no __int128)
+typedef struct {
+    unsigned long long hi;
+    unsigned long long lo;
+} Wide128;
+
+// Function to report the best level this CPU supports
+SimdLevel detectSimdLevel(void);
+
+// Functions to query or override the level in use (clamped to what the CPU supports);
+// overriding is meant for benchmarks and differential tests
+SimdLevel getSimdLevel(void);
+void setSimdLevel(SimdLevel level);
+const char *simdLevelName(SimdLevel level);
+
+// Kernels
+long long sumInts(const int *arr, size_t n);
+Wide128 sumSquaresInts(const int *arr, size_t n);
+void minMaxInts(const int *arr, size_t n, int *minValue, int *maxValue);
+
+// Function to count values into bins of binWidth starting at low; values outside
+// the bins are counted in the first or last bin. counts must hold bins entries and
+// is added to, not cleared.
+void histogramInts(const int *arr, size_t n, int low, int binWidth, size_t bins, size_t *counts);
+
+// Mean and sample variance from the exact sums; only the final division rounds
+double meanInts(const int *arr, size_t n);
+double varianceInts(const int *arr, size_t n);
+
+// Function to compute the sample variance from n, sum(x) and sum(x^2), e.g. after
+// merging partial sums (exact until the final division for n < 2^32)
+double varianceFromSums(size_t n, long long sum, Wide128 squares);
+
+// Function to add two 128-bit values
+Wide128 addWide128(Wide128 a, Wide128 b);
+
+#endif // STATS_SIMD_H
@@ -0,0 +1,245 @@
+#include <math.h>
+#include <stdio.h>
+#include "stats_stream.h"
+
+#define PI 3.14159265358979323846
+
+void streamInit(StreamStats *stats) {
+    if (!stats) {
+        printf("Invalid arguments\n");
+        return;
+    }
+    stats->count = 0;
+    stats->mean = 0.0;
+    stats->m2 = 0.0;
+    stats->min = 0.0;
+    stats->max = 0.0;
+    stats->centroidCount = 0;
+    stats->bufferCount = 0;
+    stats->digestWeight = 0.0;
+}
+
+// Function to sort centroids by mean (quicksort with insertion sort for short ranges;
+// inlined comparisons make this several times faster than qsort here)
+static void sortCentroids(Centroid *items, size_t n) {
+    while (n > 16) {
+        double a = items[0].mean, b = items[n / 2].mean, c = items[n - 1].mean;
+        double pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+        size_t i = 0;
+        size_t j = n - 1;
+        for (;;) {
+            while (items[i].mean < pivot) {
+                i++;
+            }
+            while (items[j].mean > pivot) {
+                j--;
+            }
+            if (i >= j) {
+                break;
+            }
+            Centroid temp = items[i];
+            items[i++] = items[j];
+            items[j--] = temp;
+        }
+        // Recurse on the smaller half, loop on the larger
+        if (j + 1 < n - j - 1) {
+            sortCentroids(items, j + 1);
+            items += j + 1;
+            n -= j + 1;
+        } else {
+            sortCentroids(items + j + 1, n - j - 1);
+            n = j + 1;
+        }
+    }
+    for (size_t i = 1; i < n; i++) {
+        Centroid value = items[i];
+        size_t j = i;
+        while (j > 0 && items[j - 1].mean > value.mean) {
+            items[j] = items[j - 1];
+            j--;
+        }
+        items[j] = value;
+    }
+}
+
+// Scale function k1: centroids near q = 0 and q = 1 stay small, which is what makes
+// tail quantiles accurate. A centroid may span at most one unit of k.
+static double scaleK(double q) {
+    return STREAM_COMPRESSION / (2.0 * PI) * asin(2.0 * q - 1.0);
+}
+
+static double scaleKInverse(double k) {
+    return (sin(k * 2.0 * PI / STREAM_COMPRESSION) + 1.0) / 2.0;
+}
+
+// Function to merge the buffered points into the centroids: sort everything by mean
+// and greedily combine neighbours while they fit within one unit of k
+static void compressDigest(StreamStats *stats) {
+    if (stats->bufferCount == 0) {
+        return;
+    }
+
+    size_t total = stats->centroidCount + stats->bufferCount;
+    Centroid *items = stats->centroids;
+    sortCentroids(items, total);
+
+    double weight = 0.0;
+    for (size_t i = 0; i < total; i++) {
+        weight += items[i].weight;
+    }
+
+    size_t out = 0;
+    double weightSoFar = 0.0;
+    double limit = scaleKInverse(scaleK(0.0) + 1.0) * weight;
+    Centroid current = items[0];
+
+    for (size_t i = 1; i < total; i++) {
+        if (weightSoFar + current.weight + items[i].weight <= limit) {
+            // Weighted mean; written this way to stay exact for equal means
+            current.weight += items[i].weight;
+            current.mean += (items[i].mean - current.mean) * items[i].weight / current.weight;
+        } else {
+            weightSoFar += current.weight;
+            items[out++] = current;
+            double k = scaleK(weightSoFar / weight) + 1.0;
+            limit = k >= STREAM_COMPRESSION / 4.0 ? weight : scaleKInverse(k) * weight;
+            current = items[i];
+        }
+    }
+    items[out++] = current;
+
+    stats->centroidCount = out;
+    stats->bufferCount = 0;
+    stats->digestWeight = weight;
+}
+
+// Function to queue a weighted point for the digest
+static void addCentroid(StreamStats *stats, double mean, double weight) {
+    if (stats->bufferCount == STREAM_BUFFER_SIZE) {
+        compressDigest(stats);
+    }
+    Centroid *slot = &stats->centroids[stats->centroidCount + stats->bufferCount++];
+    slot->mean = mean;
+    slot->weight = weight;
+}
+
+void streamUpdate(StreamStats *stats, double value) {
+    if (!stats) {
+        printf("Invalid arguments\n");
+        return;
+    }
+
+    // Welford's update: numerically stable for long streams
+    stats->count++;
+    double delta = value - stats->mean;
+    stats->mean += delta / (double)stats->count;
+    stats->m2 += delta * (value - stats->mean);
+
+    if (stats->count == 1 || value < stats->min) {
+        stats->min = value;
+    }
+    if (stats->count == 1 || value > stats->max) {
+        stats->max = value;
+    }
+
+    addCentroid(stats, value, 1.0);
+}
+
+void streamUpdateArray(StreamStats *stats, const int *arr, size_t n) {
+    if (!stats || (!arr && n > 0)) {
+        printf("Invalid arguments\n");
+        return;
+    }
+    for (size_t i = 0; i < n; i++) {
+        streamUpdate(stats, (double)arr[i]);
+    }
+}
+
+void streamMerge(StreamStats *dst, const StreamStats *src) {
+    if (!dst || !src) {
+        printf("Invalid arguments\n");
+        return;
+    }
+    if (src->count == 0) {
+        return;
+    }
+    if (dst->count == 0) {
+        *dst = *src;
+        return;
+    }
+
+    // Chan et al. pairwise combination of the moments
+    double n1 = (double)dst->count;
+    double n2 = (double)src->count;
+    double n = n1 + n2;
+    double delta = src->mean - dst->mean;
+    dst->mean += delta * n2 / n;
+    dst->m2 += src->m2 + delta * delta * n1 * n2 / n;
+    dst->count += src->count;
+    dst->min = src->min < dst->min ? src->min : dst->min;
+    dst->max = src->max > dst->max ? src->max : dst->max;
+
+    // src's centroids and pending points are just weighted points to dst's digest
+    size_t points = src->centroidCount + src->bufferCount;
+    for (size_t i = 0; i < points; i++) {
+        addCentroid(dst, src->centroids[i].mean, src->centroids[i].weight);
+    }
+}
+
+double streamQuantile(StreamStats *stats, double q) {
+    if (!stats || stats->count == 0) {
+        printf("No values in stream\n");
+        return 0.0;
+    }
+    if (!(q >= 0.0 && q <= 1.0)) {
+        printf("Quantile must be between 0 and 1\n");
+        return 0.0;
+    }
+    compressDigest(stats);
+
+    const Centroid *c = stats->centroids;
+    size_t count = stats->centroidCount;
+    double target = q * stats->digestWeight;
+    // Below the first centroid's center or above the last one's, interpolate
+    // towards the exact minimum or maximum
+    double firstHalf = c[0].weight / 2.0;
+    if (target <= firstHalf) {
+        return stats->min + (c[0].mean - stats->min) * target / firstHalf;
+    }
+    double lastHalf = c[count - 1].weight / 2.0;
+    if (target >= stats->digestWeight - lastHalf) {
+        return stats->max - (stats->max - c[count - 1].mean) * (stats->digestWeight - target) / lastHalf;
+    }
+
+    // Interpolate between the centers of the two centroids around the target rank
+    double center = c[0].weight / 2.0;
+    for (size_t i = 0; i + 1 < count; i++) {
+        double next = center + (c[i].weight + c[i + 1].weight) / 2.0;
+        if (target <= next) {
+            double fraction = (target - center) / (next - center);
+            return c[i].mean + fraction * (c[i + 1].mean - c[i].mean);
+        }
+        center = next;
+    }
+    return stats->max;
+}
+
+void streamFinalize(StreamStats *stats, StreamSummary *summary) {
+    if (!stats || !summary) {
+        printf("Invalid arguments\n");
+        return;
+    }
+    summary->count = stats->count;
+    summary->mean = stats->mean;
+    summary->variance = stats->count > 1 ? stats->m2 / (double)(stats->count - 1) : 0.0;
+    summary->stddev = sqrt(summary->variance);
+    summary->min = stats->min;
+    summary->max = stats->max;
+    if (stats->count == 0) {
+        summary->p50 = summary->p90 = summary->p99 = 0.0;
+        return;
+    }
+    summary->p50 = streamQuantile(stats, 0.5);
+    summary->p90 = streamQuantile(stats, 0.9);
+    summary->p99 = streamQuantile(stats, 0.99);
+}
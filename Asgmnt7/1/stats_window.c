@@ -0,0 +1,363 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stats_window.h"
+
+#define NO_COUNTER ((size_t)-1)
+
+// ---------------------------------------------------------------------------
+// Median heaps
+// ---------------------------------------------------------------------------
+
+// Function to order two slots within a heap: max-heap below the median, min-heap above
+static int heapBefore(const RollingWindow *window, int upper, size_t a, size_t b) {
+    return upper ? window->ring[a] < window->ring[b] : window->ring[a] > window->ring[b];
+}
+
+static void heapPlace(RollingWindow *window, size_t *heap, size_t index, size_t slot) {
+    heap[index] = slot;
+    window->heapIndex[slot] = index;
+}
+
+static void heapSiftUp(RollingWindow *window, int upper, size_t index) {
+    size_t *heap = upper ? window->upper : window->lower;
+    size_t slot = heap[index];
+    while (index > 0 && heapBefore(window, upper, slot, heap[(index - 1) / 2])) {
+        heapPlace(window, heap, index, heap[(index - 1) / 2]);
+        index = (index - 1) / 2;
+    }
+    heapPlace(window, heap, index, slot);
+}
+
+static void heapSiftDown(RollingWindow *window, int upper, size_t index) {
+    size_t *heap = upper ? window->upper : window->lower;
+    size_t count = upper ? window->upperCount : window->lowerCount;
+    size_t slot = heap[index];
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && heapBefore(window, upper, heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!heapBefore(window, upper, heap[child], slot)) {
+            break;
+        }
+        heapPlace(window, heap, index, heap[child]);
+        index = child;
+    }
+    heapPlace(window, heap, index, slot);
+}
+
+static void heapPush(RollingWindow *window, int upper, size_t slot) {
+    size_t *count = upper ? &window->upperCount : &window->lowerCount;
+    window->inUpper[slot] = (unsigned char)upper;
+    heapPlace(window, upper ? window->upper : window->lower, (*count)++, slot);
+    heapSiftUp(window, upper, *count - 1);
+}
+
+// Function to remove a slot from anywhere in its heap
+static void heapRemove(RollingWindow *window, size_t slot) {
+    int upper = window->inUpper[slot];
+    size_t *heap = upper ? window->upper : window->lower;
+    size_t *count = upper ? &window->upperCount : &window->lowerCount;
+    size_t index = window->heapIndex[slot];
+    size_t last = heap[--(*count)];
+    if (index == *count) {
+        return;
+    }
+    heapPlace(window, heap, index, last);
+    heapSiftUp(window, upper, index);
+    heapSiftDown(window, upper, window->heapIndex[last]);
+}
+
+// Function to move the top of one heap to the other
+static void heapTransfer(RollingWindow *window, int fromUpper) {
+    size_t slot = fromUpper ? window->upper[0] : window->lower[0];
+    heapRemove(window, slot);
+    heapPush(window, !fromUpper, slot);
+}
+
+// Function to keep the lower half equal to, or one larger than, the upper half
+static void heapBalance(RollingWindow *window) {
+    if (window->lowerCount > window->upperCount + 1) {
+        heapTransfer(window, 0);
+    } else if (window->upperCount > window->lowerCount) {
+        heapTransfer(window, 1);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Mode counters
+// ---------------------------------------------------------------------------
+
+// Function to map a value to a table slot (MurmurHash3 finalizer)
+static size_t counterSlot(int value, size_t mask) {
+    unsigned int h = (unsigned int)value;
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return (size_t)h & mask;
+}
+
+// Function to find the table slot holding value, or the empty slot where it belongs
+static size_t findCounterSlot(const RollingWindow *window, int value) {
+    size_t slot = counterSlot(value, window->tableMask);
+    while (window->table[slot] != 0 && window->counters[window->table[slot] - 1].value != value) {
+        slot = (slot + 1) & window->tableMask;
+    }
+    return slot;
+}
+
+// Function to delete a table slot, shifting later entries of the probe run back so
+// lookups never need tombstones
+static void deleteCounterSlot(RollingWindow *window, size_t slot) {
+    size_t hole = slot;
+    size_t probe = slot;
+    for (;;) {
+        probe = (probe + 1) & window->tableMask;
+        if (window->table[probe] == 0) {
+            break;
+        }
+        size_t home = counterSlot(window->counters[window->table[probe] - 1].value, window->tableMask);
+        // Move the entry if its home is not cyclically within (hole, probe]
+        if (((probe - home) & window->tableMask) >= ((probe - hole) & window->tableMask)) {
+            window->table[hole] = window->table[probe];
+            hole = probe;
+        }
+    }
+    window->table[hole] = 0;
+}
+
+// Function to order two counters in the mode heap: higher frequency first, then the
+// smaller value
+static int modeBefore(const RollingWindow *window, size_t a, size_t b) {
+    const WindowCounter *first = &window->counters[a];
+    const WindowCounter *second = &window->counters[b];
+    return first->frequency > second->frequency
+        || (first->frequency == second->frequency && first->value < second->value);
+}
+
+static void modePlace(RollingWindow *window, size_t index, size_t counter) {
+    window->modeHeap[index] = counter;
+    window->counters[counter].heapIndex = index;
+}
+
+static void modeSiftUp(RollingWindow *window, size_t index) {
+    size_t counter = window->modeHeap[index];
+    while (index > 0 && modeBefore(window, counter, window->modeHeap[(index - 1) / 2])) {
+        modePlace(window, index, window->modeHeap[(index - 1) / 2]);
+        index = (index - 1) / 2;
+    }
+    modePlace(window, index, counter);
+}
+
+static void modeSiftDown(RollingWindow *window, size_t index) {
+    size_t counter = window->modeHeap[index];
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= window->modeHeapCount) {
+            break;
+        }
+        if (child + 1 < window->modeHeapCount && modeBefore(window, window->modeHeap[child + 1], window->modeHeap[child])) {
+            child++;
+        }
+        if (!modeBefore(window, window->modeHeap[child], counter)) {
+            break;
+        }
+        modePlace(window, index, window->modeHeap[child]);
+        index = child;
+    }
+    modePlace(window, index, counter);
+}
+
+// Function to remove a counter from anywhere in the mode heap
+static void modeRemove(RollingWindow *window, size_t counter) {
+    size_t index = window->counters[counter].heapIndex;
+    size_t last = window->modeHeap[--window->modeHeapCount];
+    if (index == window->modeHeapCount) {
+        return;
+    }
+    modePlace(window, index, last);
+    modeSiftUp(window, index);
+    modeSiftDown(window, window->counters[last].heapIndex);
+}
+
+static void countValue(RollingWindow *window, int value) {
+    size_t slot = findCounterSlot(window, value);
+    size_t index;
+    if (window->table[slot] == 0) {
+        index = window->freeCounter;
+        window->freeCounter = window->counters[index].nextFree;
+        window->counters[index].value = value;
+        window->counters[index].frequency = 1;
+        window->table[slot] = index + 1;
+        modePlace(window, window->modeHeapCount++, index);
+    } else {
+        index = window->table[slot] - 1;
+        window->frequencyCount[window->counters[index].frequency]--;
+        window->counters[index].frequency++;
+    }
+    window->frequencyCount[window->counters[index].frequency]++;
+    modeSiftUp(window, window->counters[index].heapIndex);
+    if (window->counters[index].frequency > window->topFrequency) {
+        window->topFrequency = window->counters[index].frequency;
+    }
+}
+
+static void uncountValue(RollingWindow *window, int value) {
+    size_t slot = findCounterSlot(window, value);
+    size_t index = window->table[slot] - 1;
+    size_t frequency = window->counters[index].frequency;
+    window->frequencyCount[frequency]--;
+    // Frequencies change by one, so the top drops by at most one
+    if (frequency == window->topFrequency && window->frequencyCount[frequency] == 0) {
+        window->topFrequency--;
+    }
+    if (--window->counters[index].frequency > 0) {
+        window->frequencyCount[frequency - 1]++;
+        modeSiftDown(window, window->counters[index].heapIndex);
+    } else {
+        modeRemove(window, index);
+        deleteCounterSlot(window, slot);
+        window->counters[index].nextFree = window->freeCounter;
+        window->freeCounter = index;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Window
+// ---------------------------------------------------------------------------
+
+int windowInit(RollingWindow *window, size_t width) {
+    memset(window, 0, sizeof(*window));
+    if (width == 0) {
+        printf("Window width must be positive\n");
+        return -1;
+    }
+    window->width = width;
+
+    size_t tableSize = 16;
+    while (tableSize < 2 * width) {
+        tableSize *= 2;
+    }
+    window->tableMask = tableSize - 1;
+
+    window->ring = (int *)malloc(width * sizeof(int));
+    window->lower = (size_t *)malloc(width * sizeof(size_t));
+    window->upper = (size_t *)malloc(width * sizeof(size_t));
+    window->heapIndex = (size_t *)malloc(width * sizeof(size_t));
+    window->inUpper = (unsigned char *)malloc(width);
+    window->counters = (WindowCounter *)malloc(width * sizeof(WindowCounter));
+    window->table = (size_t *)calloc(tableSize, sizeof(size_t));
+    window->modeHeap = (size_t *)malloc(width * sizeof(size_t));
+    window->frequencyCount = (size_t *)calloc(width + 1, sizeof(size_t));
+    if (!window->ring || !window->lower || !window->upper || !window->heapIndex || !window->inUpper
+        || !window->counters || !window->table || !window->modeHeap || !window->frequencyCount) {
+        printf("Memory allocation failed\n");
+        return -1;
+    }
+
+    for (size_t i = 0; i < width; i++) {
+        window->counters[i].nextFree = i + 1 < width ? i + 1 : NO_COUNTER;
+    }
+    return 0;
+}
+
+void windowFree(RollingWindow *window) {
+    free(window->ring);
+    free(window->lower);
+    free(window->upper);
+    free(window->heapIndex);
+    free(window->inUpper);
+    free(window->counters);
+    free(window->table);
+    free(window->modeHeap);
+    free(window->frequencyCount);
+    memset(window, 0, sizeof(*window));
+}
+
+void windowPush(RollingWindow *window, int value) {
+    size_t slot = window->next;
+    window->next = slot + 1 < window->width ? slot + 1 : 0;
+
+    if (window->count == window->width) {
+        // Evict the oldest value, which lives in the slot being reused
+        int old = window->ring[slot];
+        unsigned long long oldSquare = (unsigned long long)((long long)old * old);
+        window->sum -= old;
+        window->squares.hi -= window->squares.lo < oldSquare;
+        window->squares.lo -= oldSquare;
+        heapRemove(window, slot);
+        uncountValue(window, old);
+    } else {
+        window->count++;
+    }
+
+    window->ring[slot] = value;
+    Wide128 square = { 0, (unsigned long long)((long long)value * value) };
+    window->sum += value;
+    window->squares = addWide128(window->squares, square);
+    heapPush(window, window->lowerCount > 0 && value > window->ring[window->lower[0]], slot);
+    heapBalance(window);
+    countValue(window, value);
+}
+
+void windowSnapshot(const RollingWindow *window, WindowStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (window->count == 0) {
+        return;
+    }
+    stats->mean = (double)window->sum / (double)window->count;
+    stats->variance = varianceFromSums(window->count, window->sum, window->squares);
+
+    int lowerTop = window->ring[window->lower[0]];
+    if (window->lowerCount > window->upperCount) {
+        stats->median = (double)lowerTop;
+    } else {
+        stats->median = ((double)lowerTop + (double)window->ring[window->upper[0]]) / 2.0;
+    }
+
+    stats->mode = window->counters[window->modeHeap[0]].value;
+    stats->modeFrequency = window->topFrequency;
+    stats->modeCount = window->frequencyCount[window->topFrequency];
+}
+
+int forEachWindow(const int *arr, size_t n, size_t width, WindowCallback callback, void *context) {
+    if (!arr || !callback || width == 0 || width > n) {
+        printf("Invalid arguments\n");
+        return -1;
+    }
+
+    RollingWindow window;
+    if (windowInit(&window, width) != 0) {
+        windowFree(&window);
+        return -1;
+    }
+    WindowStats stats;
+    for (size_t i = 0; i < n; i++) {
+        windowPush(&window, arr[i]);
+        if (i + 1 >= width) {
+            windowSnapshot(&window, &stats);
+            callback(i + 1 - width, &stats, context);
+        }
+    }
+    windowFree(&window);
+    return 0;
+}
+
+// Function to store one window's statistics at its start index (forEachWindow callback)
+static void storeWindow(size_t start, const WindowStats *stats, void *context) {
+    ((WindowStats *)context)[start] = *stats;
+}
+
+int rollingStatistics(const int *arr, size_t n, size_t width, WindowStats *out) {
+    if (!out) {
+        printf("Invalid arguments\n");
+        return -1;
+    }
+    return forEachWindow(arr, n, width, storeWindow, out);
+}
@@ -0,0 +1,84 @@
+#ifndef STATS_WINDOW_H
+#define STATS_WINDOW_H
+
+#include <stddef.h>
+#include "stats_simd.h"
+
+// Rolling statistics over the last width values of a series. Each push costs
+// O(log width), however wide the window:
+//   mean/variance  exact integer sums, updated in O(1) (no floating-point drift)
+//   median         max-heap of the lower half and min-heap of the upper half, indexed
+//                  by ring slot so the value leaving the window is removed directly
+//   mode           value counters in an indexed max-heap ordered by (frequency, then
+//                  smallest value), plus the number of values at each frequency
+// Ties for the mode go to the smallest value, as in calculateMode.
+
+typedef struct {
+    double mean;
+    double variance;        // Sample variance (n - 1); 0 for fewer than two values
+    double median;
+    int mode;
+    size_t modeFrequency;
+    size_t modeCount;       // Number of values sharing the top frequency
+} WindowStats;
+
+typedef struct {
+    int value;
+    size_t frequency;
+    size_t heapIndex;       // Position in the mode heap
+    size_t nextFree;        // Free list link while unused
+} WindowCounter;
+
+typedef struct {
+    size_t width;
+    size_t count;           // Values in the window (below width while filling)
+    size_t next;            // Ring slot for the next value
+    int *ring;
+
+    // Mean and variance
+    long long sum;
+    Wide128 squares;
+
+    // Median: heaps of ring slots
+    size_t *lower;          // Max-heap
+    size_t *upper;          // Min-heap
+    size_t lowerCount;
+    size_t upperCount;
+    size_t *heapIndex;      // Per slot: position in its heap
+    unsigned char *inUpper; // Per slot: which heap
+
+    // Mode
+    WindowCounter *counters;
+    size_t freeCounter;     // Head of the unused counters
+    size_t *table;          // Open addressing: counter index + 1, 0 when empty
+    size_t tableMask;
+    size_t *modeHeap;       // Counter indices, the mode on top
+    size_t modeHeapCount;
+    size_t *frequencyCount; // Per frequency 1..width: values with that frequency
+    size_t topFrequency;
+} RollingWindow;
+
+// Function to create an empty window; returns 0, or -1 on error. Release it with
+// windowFree() either way.
+int windowInit(RollingWindow *window, size_t width);
+void windowFree(RollingWindow *window);
+
+// Function to add a value, evicting the oldest one once the window is full
+void windowPush(RollingWindow *window, int value);
+
+// Function to report the statistics of the values currently in the window
+void windowSnapshot(const RollingWindow *window, WindowStats *stats);
+
+// Called with the start index and statistics of each full window, in order
+typedef void (*WindowCallback)(size_t start, const WindowStats *stats, void *context);
+
+// Function to compute the statistics of every full window of arr and hand each one to
+// callback as soon as it is complete, so no per-window storage is needed. Returns 0,
+// or -1 on error.
+int forEachWindow(const int *arr, size_t n, size_t width, WindowCallback callback, void *context);
+
+// Function to compute the statistics of every full window of arr: out receives
+// n - width + 1 entries. Returns 0, or -1 on error.
+int rollingStatistics(const int *arr, size_t n, size_t width, WindowStats *out);
+
+#endif // STATS_WINDOW_H